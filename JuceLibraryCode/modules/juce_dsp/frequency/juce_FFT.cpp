@@ -422,6 +422,510 @@ struct FFTFallback  : public FFT::Instance
 
 FFT::EngineImpl<FFTFallback> fftFallback;
 
+//==============================================================================
+//==============================================================================
+#if JUCE_USE_SIMD
+// Building blocks for the SIMD engines below. The complex transforms work on split real and
+// imaginary arrays as Stockham autosort FFTs made of radix-4 passes and one final radix-2 pass
+// for odd orders. Every pass reads one buffer and writes the other, and once the stride reaches
+// a SIMD register's width the butterflies run a register at a time.
+struct SIMDFFTKernels
+{
+    using Vec = SIMDRegister<float>;
+
+    static void load (float& value, const float* source) noexcept    { value = *source; }
+    static void load (Vec& value, const float* source) noexcept      { value = Vec::fromRawArray (source); }
+    static void store (float* dest, float value) noexcept            { *dest = value; }
+    static void store (float* dest, Vec value) noexcept              { value.copyToRawArray (dest); }
+
+    // inputs are a quarter of the pass length apart, outputs are one stride apart,
+    // w holds w^p, w^2p and w^3p as real and imaginary pairs
+    template <typename Type, bool applyTwiddles>
+    static forcedinline void butterfly4 (const float* inR, const float* inI, int quarter,
+                                         float* outR, float* outI, int stride, const float* w) noexcept
+    {
+        Type ar, ai, br, bi, cr, ci, dr, di;
+        load (ar, inR);               load (ai, inI);
+        load (br, inR + quarter);     load (bi, inI + quarter);
+        load (cr, inR + 2 * quarter); load (ci, inI + 2 * quarter);
+        load (dr, inR + 3 * quarter); load (di, inI + 3 * quarter);
+
+        auto apcR = ar + cr, apcI = ai + ci;
+        auto amcR = ar - cr, amcI = ai - ci;
+        auto bpdR = br + dr, bpdI = bi + di;
+
+        // j * (b - d)
+        auto jbmdR = di - bi, jbmdI = br - dr;
+
+        auto t1R = amcR - jbmdR, t1I = amcI - jbmdI;
+        auto t2R = apcR - bpdR,  t2I = apcI - bpdI;
+        auto t3R = amcR + jbmdR, t3I = amcI + jbmdI;
+
+        store (outR, apcR + bpdR);
+        store (outI, apcI + bpdI);
+
+        if (applyTwiddles)
+        {
+            store (outR + stride,     t1R * w[0] - t1I * w[1]);
+            store (outI + stride,     t1R * w[1] + t1I * w[0]);
+            store (outR + 2 * stride, t2R * w[2] - t2I * w[3]);
+            store (outI + 2 * stride, t2R * w[3] + t2I * w[2]);
+            store (outR + 3 * stride, t3R * w[4] - t3I * w[5]);
+            store (outI + 3 * stride, t3R * w[5] + t3I * w[4]);
+        }
+        else
+        {
+            store (outR + stride,     t1R); store (outI + stride,     t1I);
+            store (outR + 2 * stride, t2R); store (outI + 2 * stride, t2I);
+            store (outR + 3 * stride, t3R); store (outI + 3 * stride, t3I);
+        }
+    }
+
+    template <typename Type>
+    static forcedinline void butterfly2 (const float* xr, const float* xi, float* yr, float* yi, int stride) noexcept
+    {
+        Type ar, ai, br, bi;
+        load (ar, xr);          load (ai, xi);
+        load (br, xr + stride); load (bi, xi + stride);
+
+        store (yr, ar + br);
+        store (yi, ai + bi);
+        store (yr + stride, ar - br);
+        store (yi + stride, ai - bi);
+    }
+
+    template <typename Type>
+    static void radix4Pass (int n, int stride, const float* w,
+                            const float* xr, const float* xi, float* yr, float* yi) noexcept
+    {
+        const int quarter = n >> 2, step = (int) (sizeof (Type) / sizeof (float));
+
+        for (int p = 0; p < quarter; ++p, w += 6)
+            for (int q = 0; q < stride; q += step)
+                butterfly4<Type, true> (xr + stride * p + q, xi + stride * p + q, stride * quarter,
+                                        yr + 4 * stride * p + q, yi + 4 * stride * p + q, stride, w);
+    }
+
+    template <typename Type>
+    static void radix2Pass (int stride, const float* xr, const float* xi, float* yr, float* yi) noexcept
+    {
+        const int step = (int) (sizeof (Type) / sizeof (float));
+
+        for (int q = 0; q < stride; q += step)
+            butterfly2<Type> (xr + q, xi + q, yr + q, yi + q, stride);
+    }
+};
+
+//==============================================================================
+// Complex transform of any power of two length, with the twiddles of every pass computed up front
+struct SIMDFFTPlan
+{
+    using Vec = SIMDFFTKernels::Vec;
+
+    SIMDFFTPlan (int lengthToUse)  : length (lengthToUse)
+    {
+        int numTwiddles = 0;
+
+        for (int n = length; n >= 4; n >>= 2)
+            numTwiddles += 6 * (n >> 2);
+
+        twiddles.allocate ((size_t) jmax (1, numTwiddles), false);
+        auto* w = twiddles.getData();
+
+        for (int n = length; n >= 4; n >>= 2)
+        {
+            for (int p = 0; p < (n >> 2); ++p)
+            {
+                for (int m = 1; m <= 3; ++m)
+                {
+                    auto phase = -MathConstants<double>::twoPi * m * p / (double) n;
+                    *w++ = (float) std::cos (phase);
+                    *w++ = (float) std::sin (phase);
+                }
+            }
+        }
+    }
+
+    // the result ends up back in re and im
+    void perform (float* re, float* im, float* workRe, float* workIm) const noexcept
+    {
+        auto* xr = re;     auto* xi = im;
+        auto* yr = workRe; auto* yi = workIm;
+        auto* w = twiddles.getData();
+        int n = length, stride = 1;
+
+        for (; n >= 4; n >>= 2, stride <<= 2)
+        {
+            if (stride >= (int) Vec::size())
+                SIMDFFTKernels::radix4Pass<Vec> (n, stride, w, xr, xi, yr, yi);
+            else
+                SIMDFFTKernels::radix4Pass<float> (n, stride, w, xr, xi, yr, yi);
+
+            w += 6 * (n >> 2);
+            std::swap (xr, yr);
+            std::swap (xi, yi);
+        }
+
+        if (n == 2)
+        {
+            if (stride >= (int) Vec::size())
+                SIMDFFTKernels::radix2Pass<Vec> (stride, xr, xi, yr, yi);
+            else
+                SIMDFFTKernels::radix2Pass<float> (stride, xr, xi, yr, yi);
+
+            std::swap (xr, yr);
+            std::swap (xi, yi);
+        }
+
+        if (xr != re)
+        {
+            memcpy (re, xr, (size_t) length * sizeof (float));
+            memcpy (im, xi, (size_t) length * sizeof (float));
+        }
+    }
+
+    const int length;
+    HeapBlock<float> twiddles;
+
+    JUCE_DECLARE_NON_COPYABLE (SIMDFFTPlan)
+};
+
+//==============================================================================
+// Real and complex transforms on top of a pair of complex plans, one of half the transform size
+// for real input and one of the full size for complex input
+template <typename HalfPlan, typename FullPlan>
+struct SIMDFFTImpl  : public FFT::Instance
+{
+    using Vec = SIMDFFTKernels::Vec;
+
+    SIMDFFTImpl (int order)
+        : size (1 << order), halfPlan (size >> 1), fullPlan (size)
+    {
+        auto half = size >> 1;
+        realTwiddles.allocate ((size_t) (2 * half), false);
+
+        for (int k = 0; k < half; ++k)
+        {
+            auto phase = -MathConstants<double>::twoPi * k / (double) size;
+            realTwiddles[2 * k]     = (float) std::cos (phase);
+            realTwiddles[2 * k + 1] = (float) std::sin (phase);
+        }
+
+        scratchSpace.allocate ((size_t) (4 * size) + Vec::SIMDNumElements, true);
+        auto* scratch = Vec::getNextSIMDAlignedPtr (scratchSpace.getData());
+
+        for (int i = 0; i < 4; ++i)
+            scratchBuffers[i] = scratch + i * size;
+    }
+
+    void perform (const Complex<float>* input, Complex<float>* output, bool inverse) const noexcept override
+    {
+        const SpinLock::ScopedLockType sl (processLock);
+
+        auto* re = scratchBuffers[0];
+        auto* im = scratchBuffers[1];
+        auto sign = inverse ? -1.0f : 1.0f;
+
+        // the inverse transform is the forward transform of the conjugate, conjugated again
+        for (int i = 0; i < size; ++i)
+        {
+            re[i] = input[i].real();
+            im[i] = input[i].imag() * sign;
+        }
+
+        fullPlan.perform (re, im, scratchBuffers[2], scratchBuffers[3]);
+
+        auto scale = inverse ? 1.0f / (float) size : 1.0f;
+
+        for (int i = 0; i < size; ++i)
+            output[i] = { re[i] * scale, im[i] * sign * scale };
+    }
+
+    void performRealOnlyForwardTransform (float* d, bool ignoreNegativeFreqs) const noexcept override
+    {
+        const SpinLock::ScopedLockType sl (processLock);
+
+        auto half = size >> 1;
+        auto* re = scratchBuffers[0];
+        auto* im = scratchBuffers[1];
+
+        // even samples go in the real part and odd samples in the imaginary part of a half length transform
+        for (int i = 0; i < half; ++i)
+        {
+            re[i] = d[2 * i];
+            im[i] = d[2 * i + 1];
+        }
+
+        halfPlan.perform (re, im, scratchBuffers[2], scratchBuffers[3]);
+
+        // then the spectra of the even and odd samples are pulled apart and recombined
+        auto* out = reinterpret_cast<Complex<float>*> (d);
+        out[0]    = { re[0] + im[0], 0.0f };
+        out[half] = { re[0] - im[0], 0.0f };
+
+        for (int k = 1; k < half; ++k)
+        {
+            auto ar = re[k],        ai = im[k];
+            auto br = re[half - k], bi = -im[half - k];
+
+            auto evenR = 0.5f * (ar + br), evenI = 0.5f * (ai + bi);
+            auto oddR  = 0.5f * (ai - bi), oddI  = 0.5f * (br - ar);
+
+            auto wr = realTwiddles[2 * k], wi = realTwiddles[2 * k + 1];
+
+            out[k] = { evenR + wr * oddR - wi * oddI,
+                       evenI + wr * oddI + wi * oddR };
+        }
+
+        if (! ignoreNegativeFreqs)
+            for (int k = half + 1; k < size; ++k)
+                out[k] = std::conj (out[size - k]);
+    }
+
+    void performRealOnlyInverseTransform (float* d) const noexcept override
+    {
+        const SpinLock::ScopedLockType sl (processLock);
+
+        auto half = size >> 1;
+        auto* re = scratchBuffers[0];
+        auto* im = scratchBuffers[1];
+        auto* in = reinterpret_cast<const Complex<float>*> (d);
+
+        // rebuilds the half length spectrum from the first half of the full one, conjugated for the inverse
+        for (int k = 0; k < half; ++k)
+        {
+            auto ar = in[k].real(),        ai = in[k].imag();
+            auto br = in[half - k].real(), bi = -in[half - k].imag();
+
+            auto evenR = ar + br, evenI = ai + bi;
+            auto diffR = ar - br, diffI = ai - bi;
+
+            auto wr = realTwiddles[2 * k], wi = realTwiddles[2 * k + 1];
+            auto oddR = diffR * wr + diffI * wi;
+            auto oddI = diffI * wr - diffR * wi;
+
+            re[k] = evenR - oddI;
+            im[k] = -(evenI + oddR);
+        }
+
+        halfPlan.perform (re, im, scratchBuffers[2], scratchBuffers[3]);
+
+        auto scale = 1.0f / (float) size;
+
+        for (int i = 0; i < half; ++i)
+        {
+            d[2 * i]     = re[i] * scale;
+            d[2 * i + 1] = -im[i] * scale;
+        }
+
+        zeromem (d + size, (size_t) size * sizeof (float));
+    }
+
+    //==============================================================================
+    const int size;
+    HalfPlan halfPlan;
+    FullPlan fullPlan;
+    HeapBlock<float> realTwiddles, scratchSpace;
+    float* scratchBuffers[4];
+    SpinLock processLock;
+};
+
+//==============================================================================
+struct SIMDFFT  : public SIMDFFTImpl<SIMDFFTPlan, SIMDFFTPlan>
+{
+    // faster than the fallback, but a platform FFT library should still win when one is enabled
+    static constexpr int priority = 1;
+
+    static SIMDFFT* create (int order)
+    {
+        // real transforms run a complex transform of half the length, which needs at least four points
+        if (order < 3)
+            return nullptr;
+
+        return new SIMDFFT (order);
+    }
+
+    SIMDFFT (int order)  : SIMDFFTImpl (order) {}
+};
+
+FFT::EngineImpl<SIMDFFT> simdFFT;
+
+//==============================================================================
+// The same transforms with the length fixed at compile time, for the sizes the visualizers use.
+// Every pass is its own template instance with constant loop bounds and a constexpr twiddle table,
+// and the last radix-4 pass, whose twiddles are all one, skips the multiplications.
+namespace FixedFFT
+{
+    constexpr double sine (double x)
+    {
+        double term = x, sum = x;
+
+        for (int i = 1; i < 12; ++i)
+        {
+            term *= -x * x / ((2 * i) * (2 * i + 1));
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    constexpr double cosine (double x)
+    {
+        double term = 1.0, sum = 1.0;
+
+        for (int i = 1; i < 12; ++i)
+        {
+            term *= -x * x / ((2 * i - 1) * (2 * i));
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    // w^p, w^2p and w^3p for every p of a radix-4 pass of length N, with w^p stepped by
+    // rotation in double precision so the table stays cheap to evaluate at compile time
+    template <int N>
+    struct PassTwiddles
+    {
+        struct Table { float values[6 * (N / 4)]; };
+
+        static constexpr Table make()
+        {
+            Table table {};
+            const double c = cosine (MathConstants<double>::twoPi / N);
+            const double s = -sine (MathConstants<double>::twoPi / N);
+            double r = 1.0, i = 0.0;
+
+            for (int p = 0; p < N / 4; ++p)
+            {
+                const double r2 = r * r - i * i, i2 = 2.0 * r * i;
+                const double r3 = r2 * r - i2 * i, i3 = r2 * i + i2 * r;
+
+                table.values[6 * p]     = (float) r;
+                table.values[6 * p + 1] = (float) i;
+                table.values[6 * p + 2] = (float) r2;
+                table.values[6 * p + 3] = (float) i2;
+                table.values[6 * p + 4] = (float) r3;
+                table.values[6 * p + 5] = (float) i3;
+
+                const double nextR = r * c - i * s;
+                i = r * s + i * c;
+                r = nextR;
+            }
+
+            return table;
+        }
+
+        static constexpr Table table = make();
+    };
+
+    template <int N>
+    constexpr typename PassTwiddles<N>::Table PassTwiddles<N>::table;
+
+    template <int Stride>
+    using PassType = typename std::conditional<(Stride >= (int) SIMDFFTKernels::Vec::SIMDNumElements), SIMDFFTKernels::Vec, float>::type;
+
+    template <int N, int Stride>
+    struct Passes
+    {
+        static constexpr int numPasses = 1 + Passes<N / 4, Stride * 4>::numPasses;
+
+        static void run (float* xr, float* xi, float* yr, float* yi) noexcept
+        {
+            using Type = PassType<Stride>;
+            constexpr int quarter = N / 4, step = (int) (sizeof (Type) / sizeof (float));
+            const float* w = PassTwiddles<N>::table.values;
+
+            for (int p = 0; p < quarter; ++p, w += 6)
+                for (int q = 0; q < Stride; q += step)
+                    SIMDFFTKernels::butterfly4<Type, true> (xr + Stride * p + q, xi + Stride * p + q, Stride * quarter,
+                                                            yr + 4 * Stride * p + q, yi + 4 * Stride * p + q, Stride, w);
+
+            Passes<N / 4, Stride * 4>::run (yr, yi, xr, xi);
+        }
+    };
+
+    template <int Stride>
+    struct Passes<4, Stride>
+    {
+        static constexpr int numPasses = 1;
+
+        static void run (float* xr, float* xi, float* yr, float* yi) noexcept
+        {
+            using Type = PassType<Stride>;
+            constexpr int step = (int) (sizeof (Type) / sizeof (float));
+
+            for (int q = 0; q < Stride; q += step)
+                SIMDFFTKernels::butterfly4<Type, false> (xr + q, xi + q, Stride, yr + q, yi + q, Stride, nullptr);
+        }
+    };
+
+    template <int Stride>
+    struct Passes<2, Stride>
+    {
+        static constexpr int numPasses = 1;
+
+        static void run (float* xr, float* xi, float* yr, float* yi) noexcept
+        {
+            using Type = PassType<Stride>;
+            constexpr int step = (int) (sizeof (Type) / sizeof (float));
+
+            for (int q = 0; q < Stride; q += step)
+                SIMDFFTKernels::butterfly2<Type> (xr + q, xi + q, yr + q, yi + q, Stride);
+        }
+    };
+
+    template <int Length>
+    struct Plan
+    {
+        Plan (int lengthToUse)
+        {
+            jassert (lengthToUse == Length);
+            ignoreUnused (lengthToUse);
+        }
+
+        void perform (float* re, float* im, float* workRe, float* workIm) const noexcept
+        {
+            Passes<Length, 1>::run (re, im, workRe, workIm);
+
+            if ((Passes<Length, 1>::numPasses & 1) != 0)
+            {
+                memcpy (re, workRe, (size_t) Length * sizeof (float));
+                memcpy (im, workIm, (size_t) Length * sizeof (float));
+            }
+        }
+    };
+
+    template <int Order>
+    using Impl = SIMDFFTImpl<Plan<(1 << Order) / 2>, Plan<(1 << Order)>>;
+}
+
+struct FixedOrderFFT
+{
+    // ahead of the generic SIMD engine for the orders it has kernels for
+    static constexpr int priority = 2;
+
+    static constexpr int minOrder = 8;
+    static constexpr int maxOrder = 13;
+
+    static FFT::Instance* create (int order)
+    {
+        switch (order)
+        {
+            case 8:   return new FixedFFT::Impl<8>  (order);
+            case 9:   return new FixedFFT::Impl<9>  (order);
+            case 10:  return new FixedFFT::Impl<10> (order);
+            case 11:  return new FixedFFT::Impl<11> (order);
+            case 12:  return new FixedFFT::Impl<12> (order);
+            case 13:  return new FixedFFT::Impl<13> (order);
+            default:  return nullptr;
+        }
+    }
+};
+
+FFT::EngineImpl<FixedOrderFFT> fixedOrderFFT;
+#endif
+
 //==============================================================================
 //==============================================================================
 #if (JUCE_MAC || JUCE_IOS) && JUCE_USE_VDSP_FRAMEWORK
@@ -193,6 +193,176 @@ struct FFTUnitTest  : public UnitTest
         }
     };
 
+   #if JUCE_USE_SIMD
+    struct SIMDEngineTest
+    {
+        static void run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (int order = 3; order <= 14; ++order)
+            {
+                auto n = (size_t) (1 << order);
+
+                std::unique_ptr<FFTFallback> fallback (FFTFallback::create (order));
+                std::unique_ptr<SIMDFFT> simd (SIMDFFT::create (order));
+
+                HeapBlock<float> input (n), expected (n << 1), actual (n << 1);
+                fillRandom (random, input.getData(), n);
+
+                // results grow with the length, so the tolerance is relative to it
+                auto tolerance = 1e-5f * (float) n;
+
+                for (int ignoreNegativeFreqs = 0; ignoreNegativeFreqs < 2; ++ignoreNegativeFreqs)
+                {
+                    zeromem (expected.getData(), (n << 1) * sizeof (float));
+                    zeromem (actual.getData(), (n << 1) * sizeof (float));
+                    memcpy (expected.getData(), input.getData(), n * sizeof (float));
+                    memcpy (actual.getData(), input.getData(), n * sizeof (float));
+
+                    fallback->performRealOnlyForwardTransform (expected.getData(), ignoreNegativeFreqs != 0);
+                    simd->performRealOnlyForwardTransform (actual.getData(), ignoreNegativeFreqs != 0);
+
+                    auto numFloats = ignoreNegativeFreqs != 0 ? n + 2 : n << 1;
+                    u.expect (checkArrayIsWithin (expected.getData(), actual.getData(), numFloats, tolerance));
+                }
+
+                simd->performRealOnlyInverseTransform (actual.getData());
+                u.expect (checkArrayIsWithin (input.getData(), actual.getData(), n, 1e-4f));
+
+                HeapBlock<Complex<float>> complexInput (n), complexExpected (n), complexActual (n);
+                fillRandom (random, complexInput.getData(), n);
+
+                for (int inverse = 0; inverse < 2; ++inverse)
+                {
+                    fallback->perform (complexInput.getData(), complexExpected.getData(), inverse != 0);
+                    simd->perform (complexInput.getData(), complexActual.getData(), inverse != 0);
+
+                    u.expect (checkArrayIsWithin ((float*) complexExpected.getData(), (float*) complexActual.getData(),
+                                                  n << 1, inverse != 0 ? 1e-4f : tolerance));
+                }
+            }
+        }
+
+        static bool checkArrayIsWithin (const float* a, const float* b, size_t n, float tolerance) noexcept
+        {
+            for (size_t i = 0; i < n; ++i)
+                if (std::abs (a[i] - b[i]) > tolerance)
+                    return false;
+
+            return true;
+        }
+    };
+
+    struct FixedOrderEngineTest
+    {
+        static void run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (int order = FixedOrderFFT::minOrder; order <= FixedOrderFFT::maxOrder; ++order)
+            {
+                auto n = (size_t) (1 << order);
+
+                std::unique_ptr<SIMDFFT> generic (SIMDFFT::create (order));
+                std::unique_ptr<FFT::Instance> fixed (FixedOrderFFT::create (order));
+
+                HeapBlock<float> input (n), expected (n << 1), actual (n << 1);
+                fillRandom (random, input.getData(), n);
+
+                zeromem (expected.getData(), (n << 1) * sizeof (float));
+                zeromem (actual.getData(), (n << 1) * sizeof (float));
+                memcpy (expected.getData(), input.getData(), n * sizeof (float));
+                memcpy (actual.getData(), input.getData(), n * sizeof (float));
+
+                generic->performRealOnlyForwardTransform (expected.getData(), false);
+                fixed->performRealOnlyForwardTransform (actual.getData(), false);
+
+                auto tolerance = 1e-5f * (float) n;
+                u.expect (SIMDEngineTest::checkArrayIsWithin (expected.getData(), actual.getData(), n << 1, tolerance));
+
+                fixed->performRealOnlyInverseTransform (actual.getData());
+                u.expect (SIMDEngineTest::checkArrayIsWithin (input.getData(), actual.getData(), n, 1e-4f));
+
+                HeapBlock<Complex<float>> complexInput (n), complexExpected (n), complexActual (n);
+                fillRandom (random, complexInput.getData(), n);
+
+                for (int inverse = 0; inverse < 2; ++inverse)
+                {
+                    generic->perform (complexInput.getData(), complexExpected.getData(), inverse != 0);
+                    fixed->perform (complexInput.getData(), complexActual.getData(), inverse != 0);
+
+                    u.expect (SIMDEngineTest::checkArrayIsWithin ((float*) complexExpected.getData(), (float*) complexActual.getData(),
+                                                                  n << 1, inverse != 0 ? 1e-4f : tolerance));
+                }
+            }
+        }
+    };
+
+    struct SIMDEngineBenchmark
+    {
+        static double timeEngine (FFT::Instance& engine, const float* input, float* buffer, int order)
+        {
+            auto n = (size_t) (1 << order);
+            const int numIterations = (1 << 22) >> order;
+            auto start = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numIterations; ++i)
+            {
+                memcpy (buffer, input, n * sizeof (float));
+                engine.performRealOnlyForwardTransform (buffer, false);
+            }
+
+            return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) / numIterations;
+        }
+
+        static void run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (int order = 8; order <= 14; ++order)
+            {
+                auto n = (size_t) (1 << order);
+
+                std::unique_ptr<FFTFallback> fallback (FFTFallback::create (order));
+                std::unique_ptr<SIMDFFT> simd (SIMDFFT::create (order));
+                std::unique_ptr<FFT::Instance> fixed (FixedOrderFFT::create (order));
+
+                HeapBlock<float> input (n), buffer (n << 1);
+                fillRandom (random, input.getData(), n);
+
+                // The best of several interleaved runs, so a busy machine slowing down one run doesn't skew the ratio
+                auto fallbackTime = std::numeric_limits<double>::max();
+                auto simdTime = std::numeric_limits<double>::max();
+
+                for (int run = 0; run < 5; ++run)
+                {
+                    fallbackTime = jmin (fallbackTime, timeEngine (*fallback, input.getData(), buffer.getData(), order));
+                    simdTime = jmin (simdTime, timeEngine (*simd, input.getData(), buffer.getData(), order));
+                }
+
+                String message ("Order " + String (order) + ": fallback " + String (fallbackTime * 1.0e6, 2)
+                                  + " us, SIMD " + String (simdTime * 1.0e6, 2)
+                                  + " us (" + String (fallbackTime / simdTime, 1) + "x)");
+
+                if (fixed != nullptr)
+                {
+                    auto fixedTime = timeEngine (*fixed, input.getData(), buffer.getData(), order);
+                    message << ", fixed order " << String (fixedTime * 1.0e6, 2)
+                            << " us (" << String (fallbackTime / fixedTime, 1) << "x)";
+                }
+
+                u.logMessage (message);
+
+               #if ! JUCE_DEBUG
+                // Timings from unoptimised builds say nothing about the engine, so only optimised builds check the speedup
+                u.expectGreaterOrEqual (fallbackTime / simdTime, 3.0, message);
+               #endif
+            }
+        }
+    };
+   #endif
+
     template <class TheTest>
     void runTestForAllTypes (const char* unitTestName)
     {
@@ -206,6 +376,12 @@ struct FFTUnitTest  : public UnitTest
         runTestForAllTypes<RealTest> ("Real input numbers Test");
         runTestForAllTypes<FrequencyOnlyTest> ("Frequency only Test");
         runTestForAllTypes<ComplexTest> ("Complex input numbers Test");
+
+       #if JUCE_USE_SIMD
+        runTestForAllTypes<SIMDEngineTest> ("SIMD engine matches fallback Test");
+        runTestForAllTypes<FixedOrderEngineTest> ("Fixed order engine matches SIMD engine Test");
+        runTestForAllTypes<SIMDEngineBenchmark> ("SIMD engine speed Test");
+       #endif
     }
 };
 
@@ -0,0 +1,293 @@
+/*
+  ==============================================================================
+
+    AnalysisGraph.cpp
+    Created: 19 Oct 2026 6:31:40pm
+    Author:  Esteban Cambronero
+    Graph of analysis nodes with typed ports, compiled into a flat schedule over one arena
+  ==============================================================================
+*/
+
+#include "AnalysisGraph.h"
+
+// Buffers in the arena start on 16 byte boundaries
+#define ARENA_ALIGNMENT 4
+
+/*
+ Node standing in for the audio handed to AnalysisGraph::process, which copies it straight into the node's output
+ */
+class GraphInputNode : public AnalysisNode
+{
+public:
+    GraphInputNode(int numChannels, int numSamples) {
+        addOutput(AUDIO_PORT, numChannels * numSamples);
+    }
+    void process(const float* const*, float* const*) override {}
+};
+
+/*
+ Declares an input port, called from a node's constructor
+ */
+void AnalysisNode::addInput(PortType type, int size) {
+    inputPorts.add({ type, size });
+}
+
+/*
+ Declares an output port, called from a node's constructor
+ */
+void AnalysisNode::addOutput(PortType type, int size) {
+    outputPorts.add({ type, size });
+}
+
+/*
+ Constructor for an empty analysis graph
+ */
+AnalysisGraph::AnalysisGraph() {
+    arenaSize = 0;
+    inputNode = -1;
+    inputChannels = 0;
+    inputSamples = 0;
+    compiled = false;
+}
+
+/*
+ Removes every node, connection and output
+ */
+void AnalysisGraph::clear() {
+    nodes.clear();
+    connections.clear();
+    outputs.clear();
+    schedule.clear();
+    portPointers.clear();
+    outputPointers.clear();
+    arena.free();
+    arenaSize = 0;
+    inputNode = -1;
+    compiled = false;
+}
+
+/*
+ Adds the node the audio enters through, its single output is an audio port
+ */
+int AnalysisGraph::setInput(int numChannels, int numSamples) {
+    jassert(inputNode < 0);
+    inputChannels = numChannels;
+    inputSamples = numSamples;
+    inputNode = addNode(new GraphInputNode(numChannels, numSamples));
+    return inputNode;
+}
+
+/*
+ Adds a node, which the graph then owns, and returns its id
+ */
+int AnalysisGraph::addNode(AnalysisNode *node) {
+    compiled = false;
+    nodes.add(node);
+    return nodes.size() - 1;
+}
+
+/*
+ Connects an output to an input, fails if the port types or sizes differ or the input is already connected
+ */
+bool AnalysisGraph::connect(int sourceNode, int sourcePort, int destNode, int destPort) {
+    if(! isPositiveAndBelow(sourceNode, nodes.size()) || ! isPositiveAndBelow(destNode, nodes.size()))
+        return false;
+    if(! isPositiveAndBelow(sourcePort, nodes[sourceNode]->getNumOutputs()) || ! isPositiveAndBelow(destPort, nodes[destNode]->getNumInputs()))
+        return false;
+    
+    const PortSpec source = nodes[sourceNode]->getOutputSpec(sourcePort);
+    const PortSpec dest = nodes[destNode]->getInputSpec(destPort);
+    if(source.type != dest.type || source.size != dest.size || findConnection(destNode, destPort) >= 0)
+        return false;
+    
+    compiled = false;
+    connections.add({ sourceNode, sourcePort, destNode, destPort });
+    return true;
+}
+
+/*
+ Marks an output port as a result of the graph, its buffer is kept intact until the next run
+ */
+int AnalysisGraph::addOutput(int node, int port) {
+    compiled = false;
+    outputs.add({ node, port, -1, -1 });
+    return outputs.size() - 1;
+}
+
+/*
+ Orders the nodes so every node runs after its inputs, then lays their buffers out in one arena
+ A buffer's space is handed to later buffers once the last node reading it has run, so a long chain
+ only needs room for what is live at any one step
+ */
+Result AnalysisGraph::compile() {
+    compiled = false;
+    schedule.clear();
+    portPointers.clear();
+    outputPointers.clear();
+    
+    const int numNodes = nodes.size();
+    if(inputNode < 0)
+        return Result::fail("The analysis graph has no input");
+    
+    // Every input must be fed
+    Array<int> pendingInputs;
+    for(int node = 0; node < numNodes; node++) {
+        for(int port = 0; port < nodes[node]->getNumInputs(); port++)
+            if(findConnection(node, port) < 0)
+                return Result::fail("Input " + String(port) + " of node " + String(node) + " is not connected");
+        pendingInputs.add(nodes[node]->getNumInputs());
+    }
+    
+    // Topological order, starting from the graph input so its buffer exists before anything runs
+    Array<int> order;
+    order.add(inputNode);
+    for(int node = 0; node < numNodes; node++)
+        if(node != inputNode && pendingInputs[node] == 0)
+            order.add(node);
+    
+    for(int i = 0; i < order.size(); i++) {
+        for(const Connection &connection : connections) {
+            if(connection.sourceNode != order[i])
+                continue;
+            pendingInputs.set(connection.destNode, pendingInputs[connection.destNode] - 1);
+            if(pendingInputs[connection.destNode] == 0)
+                order.add(connection.destNode);
+        }
+    }
+    
+    if(order.size() != numNodes)
+        return Result::fail("The analysis graph has a cycle");
+    
+    // One buffer per output port, live from the step producing it to the last step reading it
+    Array<int> stepOfNode, firstBuffer, lastUse, bufferSize, bufferOffset;
+    stepOfNode.insertMultiple(0, 0, numNodes);
+    for(int step = 0; step < numNodes; step++)
+        stepOfNode.set(order[step], step);
+    
+    for(int node = 0; node < numNodes; node++) {
+        firstBuffer.add(bufferSize.size());
+        for(int port = 0; port < nodes[node]->getNumOutputs(); port++) {
+            bufferSize.add((nodes[node]->getOutputSpec(port).size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT);
+            lastUse.add(stepOfNode[node]);
+            bufferOffset.add(-1);
+        }
+    }
+    
+    for(const Connection &connection : connections) {
+        const int buffer = firstBuffer[connection.sourceNode] + connection.sourcePort;
+        lastUse.set(buffer, jmax(lastUse[buffer], stepOfNode[connection.destNode]));
+    }
+    for(const Connection &output : outputs)
+        lastUse.set(firstBuffer[output.sourceNode] + output.sourcePort, numNodes);
+    
+    // Outputs take the best fitting free region or grow the arena, inputs are only freed after
+    // the step's outputs are placed so a node never reads and writes the same memory
+    Array<Region> freeRegions;
+    int end = 0;
+    
+    for(int step = 0; step < numNodes; step++) {
+        const int node = order[step];
+        
+        for(int port = 0; port < nodes[node]->getNumOutputs(); port++) {
+            const int buffer = firstBuffer[node] + port;
+            const int size = bufferSize[buffer];
+            int best = -1;
+            
+            for(int i = 0; i < freeRegions.size(); i++)
+                if(freeRegions[i].size >= size && (best < 0 || freeRegions[i].size < freeRegions[best].size))
+                    best = i;
+            
+            if(best >= 0) {
+                Region region = freeRegions[best];
+                bufferOffset.set(buffer, region.offset);
+                if(region.size > size)
+                    freeRegions.set(best, { region.offset + size, region.size - size });
+                else
+                    freeRegions.remove(best);
+            }
+            else {
+                bufferOffset.set(buffer, end);
+                end += size;
+            }
+        }
+        
+        for(int buffer = 0; buffer < bufferSize.size(); buffer++)
+            if(lastUse[buffer] == step && bufferOffset[buffer] >= 0)
+                freeRegions.add({ bufferOffset[buffer], bufferSize[buffer] });
+    }
+    
+    arenaSize = end;
+    arena.allocate((size_t) jmax(1, arenaSize), true);
+    
+    // Flatten every step's port buffers into one pointer table
+    for(int step = 0; step < numNodes; step++) {
+        const int node = order[step];
+        Step entry;
+        entry.node = nodes[node];
+        entry.firstInput = portPointers.size();
+        
+        for(int port = 0; port < nodes[node]->getNumInputs(); port++) {
+            const Connection &connection = connections.getReference(findConnection(node, port));
+            portPointers.add(arena + bufferOffset[firstBuffer[connection.sourceNode] + connection.sourcePort]);
+        }
+        
+        entry.firstOutput = portPointers.size();
+        for(int port = 0; port < nodes[node]->getNumOutputs(); port++)
+            portPointers.add(arena + bufferOffset[firstBuffer[node] + port]);
+        
+        schedule.add(entry);
+    }
+    
+    // Keeps the table from being empty, so the step offsets are always valid
+    portPointers.add(nullptr);
+    
+    for(const Connection &output : outputs)
+        outputPointers.add(arena + bufferOffset[firstBuffer[output.sourceNode] + output.sourcePort]);
+    
+    compiled = true;
+    return Result::ok();
+}
+
+/*
+ Copies the audio into the input buffer and runs the schedule, nothing is allocated here
+ */
+void AnalysisGraph::process(const AudioBuffer<float> &input) {
+    if(! compiled)
+        return;
+    
+    // The input node is always the first step
+    float *dest = portPointers[schedule.getReference(0).firstOutput];
+    const int numSamples = jmin(inputSamples, input.getNumSamples());
+    
+    FloatVectorOperations::clear(dest, inputChannels * inputSamples);
+    for(int channel = 0; channel < jmin(inputChannels, input.getNumChannels()); channel++)
+        FloatVectorOperations::copy(dest + channel * inputSamples, input.getReadPointer(channel), numSamples);
+    
+    float **pointers = portPointers.getRawDataPointer();
+    for(const Step &step : schedule)
+        step.node->process(pointers + step.firstInput, pointers + step.firstOutput);
+}
+
+/*
+ Buffer of a graph output, valid until the next run
+ */
+const float* AnalysisGraph::getOutput(int index) const {
+    return outputPointers[index];
+}
+
+/*
+ Number of floats in the arena after compiling
+ */
+int AnalysisGraph::getArenaSize() const {
+    return arenaSize;
+}
+
+/*
+ Index of the connection feeding an input port, or -1
+ */
+int AnalysisGraph::findConnection(int destNode, int destPort) const {
+    for(int i = 0; i < connections.size(); i++)
+        if(connections.getReference(i).destNode == destNode && connections.getReference(i).destPort == destPort)
+            return i;
+    return -1;
+}
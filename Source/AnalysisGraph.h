@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    AnalysisGraph.h
+    Created: 19 Oct 2026 6:31:40pm
+    Author:  Esteban Cambronero
+    Graph of analysis nodes with typed ports, compiled into a flat schedule over one arena
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+
+enum PortType {
+    AUDIO_PORT,         // planar channels, one block after another
+    SIGNAL_PORT,        // mono samples
+    SPECTRUM_PORT,      // interleaved real and imaginary FFT output
+    MAGNITUDE_PORT,     // one magnitude per bin
+    BAND_PORT,          // one level per display band
+    FEATURE_PORT        // scalar features
+};
+
+struct PortSpec {
+    PortType type;
+    int size;
+};
+
+/*
+ A step of the analysis, it declares its ports when constructed and is handed buffers of exactly those sizes
+ Anything a node keeps between runs is its own, everything passed between nodes lives in the graph's arena
+ */
+class AnalysisNode
+{
+public:
+    virtual ~AnalysisNode() {}
+    virtual void process(const float* const* inputs, float* const* outputs) = 0;
+    
+    int getNumInputs() const noexcept                   { return inputPorts.size(); }
+    int getNumOutputs() const noexcept                  { return outputPorts.size(); }
+    PortSpec getInputSpec(int port) const noexcept      { return inputPorts[port]; }
+    PortSpec getOutputSpec(int port) const noexcept     { return outputPorts[port]; }
+protected:
+    void addInput(PortType type, int size);
+    void addOutput(PortType type, int size);
+private:
+    Array<PortSpec> inputPorts;
+    Array<PortSpec> outputPorts;
+};
+
+class AnalysisGraph
+{
+public:
+    AnalysisGraph();
+    void clear();
+    int setInput(int numChannels, int numSamples);
+    int addNode(AnalysisNode *node);
+    bool connect(int sourceNode, int sourcePort, int destNode, int destPort);
+    int addOutput(int node, int port);
+    Result compile();
+    void process(const AudioBuffer<float> &input);
+    const float* getOutput(int index) const;
+    int getArenaSize() const;
+private:
+    struct Connection {
+        int sourceNode, sourcePort, destNode, destPort;
+    };
+    struct Step {
+        AnalysisNode *node;
+        int firstInput;
+        int firstOutput;
+    };
+    struct Region {
+        int offset, size;
+    };
+    int findConnection(int destNode, int destPort) const;
+    
+    OwnedArray<AnalysisNode> nodes;
+    Array<Connection> connections;
+    Array<Connection> outputs;
+    
+    // Filled in by compile(), after which running the graph touches nothing but these
+    Array<Step> schedule;
+    Array<float*> portPointers;
+    Array<float*> outputPointers;
+    HeapBlock<float> arena;
+    int arenaSize;
+    
+    int inputNode;
+    int inputChannels;
+    int inputSamples;
+    bool compiled;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalysisGraph)
+};
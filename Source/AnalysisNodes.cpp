@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    AnalysisNodes.cpp
+    Created: 19 Oct 2026 6:31:40pm
+    Author:  Esteban Cambronero
+    Stock nodes for the analysis graph
+  ==============================================================================
+*/
+
+#include "AnalysisNodes.h"
+
+/*
+ Constructor for the downmix node
+ */
+DownmixNode::DownmixNode(int channels, int samples, int first, int toMix) : numSamples(samples), firstChannel(first), channelsToMix(toMix) {
+    jassert(firstChannel + channelsToMix <= channels);
+    addInput(AUDIO_PORT, channels * samples);
+    addOutput(SIGNAL_PORT, samples);
+}
+
+void DownmixNode::process(const float* const* inputs, float* const* outputs) {
+    const float *audio = inputs[0] + firstChannel * numSamples;
+    FloatVectorOperations::copy(outputs[0], audio, numSamples);
+    for(int channel = 1; channel < channelsToMix; channel++)
+        FloatVectorOperations::add(outputs[0], audio + channel * numSamples, numSamples);
+}
+
+/*
+ Constructor for the window node, the window is computed once here
+ */
+WindowNode::WindowNode(int windowSize, dsp::WindowingFunction<float>::WindowingMethod method) : size(windowSize) {
+    window.allocate(size, true);
+    dsp::WindowingFunction<float>::fillWindowingTables(window, size, method, false);
+    addInput(SIGNAL_PORT, size);
+    addOutput(SIGNAL_PORT, size);
+}
+
+void WindowNode::process(const float* const* inputs, float* const* outputs) {
+    FloatVectorOperations::multiply(outputs[0], inputs[0], window, size);
+}
+
+/*
+ Constructor for the FFT node, the plan comes from the shared cache
+ */
+FFTNode::FFTNode(int order, int signalSize) : fftSize(1 << order), inputSize(signalSize), fft(fftPlans->getPlan(order)) {
+    jassert(inputSize <= fftSize);
+    addInput(SIGNAL_PORT, inputSize);
+    addOutput(SPECTRUM_PORT, 2 * fftSize);
+}
+
+void FFTNode::process(const float* const* inputs, float* const* outputs) {
+    FloatVectorOperations::copy(outputs[0], inputs[0], inputSize);
+    FloatVectorOperations::clear(outputs[0] + inputSize, 2 * fftSize - inputSize);
+    fft.performRealOnlyForwardTransform(outputs[0], true);
+}
+
+/*
+ Constructor for the magnitude node
+ */
+MagnitudeNode::MagnitudeNode(int order) : numBins((1 << order) / 2 + 1) {
+    addInput(SPECTRUM_PORT, 2 << order);
+    addOutput(MAGNITUDE_PORT, numBins);
+}
+
+void MagnitudeNode::process(const float* const* inputs, float* const* outputs) {
+    const float *spectrum = inputs[0];
+    for(int bin = 0; bin < numBins; bin++)
+        outputs[0][bin] = std::sqrt(spectrum[2 * bin] * spectrum[2 * bin] + spectrum[2 * bin + 1] * spectrum[2 * bin + 1]);
+}
+
+/*
+ Constructor for the band map node, the bin of every band is worked out once here
+ */
+BandMapNode::BandMapNode(int bins, int bands, float skew, float bandHeight) : numBins(bins), numBands(bands), height(bandHeight) {
+    binForBand.allocate(numBands, true);
+    for(int band = 0; band < numBands; band++) {
+        const float skewedProportion = 1.0f - std::exp(std::log(band / ((float) numBands - 1.0f)) * skew);
+        binForBand[band] = jlimit(0, numBins - 1, (int) (skewedProportion * (numBins - 1)));
+    }
+    
+    addInput(MAGNITUDE_PORT, numBins);
+    addOutput(BAND_PORT, numBands);
+}
+
+void BandMapNode::process(const float* const* inputs, float* const* outputs) {
+    const float maxLevel = FloatVectorOperations::findMaximum(inputs[0], numBins - 1);
+    
+    for(int band = 0; band < numBands; band++)
+        outputs[0][band] = maxLevel != 0.0f ? jmap(inputs[0][binForBand[band]], 0.0f, maxLevel, 0.0f, height) : 0.0f;
+}
+
+/*
+ Constructor for the smoothing node, a coefficient of one follows the input immediately
+ */
+SmoothingNode::SmoothingNode(PortType type, int portSize, float smoothing) : size(portSize), coefficient(smoothing) {
+    state.allocate(size, true);
+    addInput(type, size);
+    addOutput(type, size);
+}
+
+void SmoothingNode::process(const float* const* inputs, float* const* outputs) {
+    for(int i = 0; i < size; i++)
+        state[i] += coefficient * (inputs[0][i] - state[i]);
+    FloatVectorOperations::copy(outputs[0], state, size);
+}
+
+/*
+ Constructor for the spectral feature node
+ */
+SpectralFeatureNode::SpectralFeatureNode(int bins) : numBins(bins) {
+    addInput(MAGNITUDE_PORT, numBins);
+    addOutput(FEATURE_PORT, NUM_FEATURES);
+}
+
+void SpectralFeatureNode::process(const float* const* inputs, float* const* outputs) {
+    const float *magnitudes = inputs[0];
+    float sum = 0.0f, weightedSum = 0.0f, logSum = 0.0f;
+    int peak = 0;
+    
+    for(int bin = 0; bin < numBins; bin++) {
+        sum += magnitudes[bin];
+        weightedSum += bin * magnitudes[bin];
+        logSum += std::log(magnitudes[bin] + 1.0e-12f);
+        if(magnitudes[bin] > magnitudes[peak])
+            peak = bin;
+    }
+    
+    const float nyquistBin = (float) (numBins - 1);
+    const float mean = sum / numBins;
+    outputs[0][CENTROID] = sum > 0.0f ? weightedSum / sum / nyquistBin : 0.0f;
+    outputs[0][PEAK] = peak / nyquistBin;
+    outputs[0][FLATNESS] = mean > 0.0f ? std::exp(logSum / numBins) / mean : 0.0f;
+}
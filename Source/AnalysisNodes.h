@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    AnalysisNodes.h
+    Created: 19 Oct 2026 6:31:40pm
+    Author:  Esteban Cambronero
+    Stock nodes for the analysis graph
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AnalysisGraph.h"
+#include "FFTPlanCache.h"
+
+/*
+ Sums a run of channels of an audio port into one signal
+ */
+class DownmixNode : public AnalysisNode
+{
+public:
+    DownmixNode(int numChannels, int numSamples, int firstChannel, int channelsToMix);
+    void process(const float* const* inputs, float* const* outputs) override;
+private:
+    int numSamples;
+    int firstChannel;
+    int channelsToMix;
+};
+
+/*
+ Multiplies a signal by a window
+ */
+class WindowNode : public AnalysisNode
+{
+public:
+    WindowNode(int size, dsp::WindowingFunction<float>::WindowingMethod method);
+    void process(const float* const* inputs, float* const* outputs) override;
+private:
+    int size;
+    HeapBlock<float> window;
+};
+
+/*
+ Zero pads a signal to the FFT size and transforms it
+ */
+class FFTNode : public AnalysisNode
+{
+public:
+    FFTNode(int order, int inputSize);
+    void process(const float* const* inputs, float* const* outputs) override;
+private:
+    int fftSize;
+    int inputSize;
+    SharedResourcePointer<FFTPlanCache> fftPlans;
+    dsp::FFT &fft;
+};
+
+/*
+ Magnitudes of the bins from DC to Nyquist
+ */
+class MagnitudeNode : public AnalysisNode
+{
+public:
+    MagnitudeNode(int order);
+    void process(const float* const* inputs, float* const* outputs) override;
+private:
+    int numBins;
+};
+
+/*
+ Picks one bin per band on a skewed log scale and scales the bands so the loudest bin reaches the given height
+ */
+class BandMapNode : public AnalysisNode
+{
+public:
+    BandMapNode(int numBins, int numBands, float skew, float height);
+    void process(const float* const* inputs, float* const* outputs) override;
+private:
+    int numBins;
+    int numBands;
+    float height;
+    HeapBlock<int> binForBand;
+};
+
+/*
+ Exponential smoothing of any port between runs
+ */
+class SmoothingNode : public AnalysisNode
+{
+public:
+    SmoothingNode(PortType type, int size, float coefficient);
+    void process(const float* const* inputs, float* const* outputs) override;
+private:
+    int size;
+    float coefficient;
+    HeapBlock<float> state;
+};
+
+/*
+ Spectral centroid and peak bin as fractions of Nyquist, and spectral flatness
+ */
+class SpectralFeatureNode : public AnalysisNode
+{
+public:
+    enum Feature {
+        CENTROID,
+        PEAK,
+        FLATNESS,
+        NUM_FEATURES
+    };
+    SpectralFeatureNode(int numBins);
+    void process(const float* const* inputs, float* const* outputs) override;
+private:
+    int numBins;
+};
@@ -0,0 +1,28 @@
+/*
+  ==============================================================================
+
+    AnalysisStage.h
+    Created: 19 Oct 2026 10:12:41am
+    Author:  Esteban Cambronero
+    Interface for the processing stages run by the analysis thread
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+
+class AnalysisStage
+{
+public:
+    virtual ~AnalysisStage() {}
+    
+    /*
+     Called on the analysis thread before the first block, and again whenever the stream format changes
+     */
+    virtual void prepare(double sampleRate, int numChannels, int maxBlockSize) = 0;
+    
+    /*
+     Called on the analysis thread with every new block of samples pulled from the circular buffer
+     */
+    virtual void process(const AudioBuffer<float> &block, int numSamples) = 0;
+};
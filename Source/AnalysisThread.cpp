@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    AnalysisThread.cpp
+    Created: 19 Oct 2026 10:12:41am
+    Author:  Esteban Cambronero
+    Background thread that streams audio out of the circular buffer into the analysis stages
+  ==============================================================================
+*/
+
+#include "AnalysisThread.h"
+
+/*
+ Constructor for the analysis thread, starts reading from the current write position of the buffer
+ */
+AnalysisThread::AnalysisThread(CircularBuffer *buffer, double rate) : Thread("Analysis Thread"), block(buffer->getNumChannels(), ANALYSIS_BLOCK_SIZE)
+{
+    circBuffer = buffer;
+    sampleRate = rate;
+    readPosition = circBuffer->getWritePosition();
+}
+
+/*
+ Destructor for the analysis thread, waits for the thread to finish its current block
+ */
+AnalysisThread::~AnalysisThread() {
+    stopThread(1000);
+    circBuffer = nullptr;
+}
+
+/*
+ Adds a stage to the end of the processing chain, the stage is not owned by the thread
+ Adding a stage that is already running does nothing
+ */
+void AnalysisThread::addStage(AnalysisStage *stage) {
+    const ScopedLock sl(stageLock);
+    
+    if(stages.contains(stage))
+        return;
+    
+    stage->prepare(sampleRate, block.getNumChannels(), ANALYSIS_BLOCK_SIZE);
+    stages.add(stage);
+}
+
+/*
+ Removes a stage from the processing chain, once this returns the stage will not be called again
+ */
+void AnalysisThread::removeStage(AnalysisStage *stage) {
+    const ScopedLock sl(stageLock);
+    stages.removeFirstMatchingValue(stage);
+}
+
+/*
+ Adds a listener to be told about every processed block, the listener is not owned by the thread
+ */
+void AnalysisThread::addListener(Listener *listener) {
+    const ScopedLock sl(stageLock);
+    listeners.addIfNotAlreadyThere(listener);
+}
+
+/*
+ Removes a listener, once this returns it will not be called again
+ */
+void AnalysisThread::removeListener(Listener *listener) {
+    const ScopedLock sl(stageLock);
+    listeners.removeFirstMatchingValue(listener);
+}
+
+/*
+ Pulls every new block out of the circular buffer, waiting a little whenever there is none
+ */
+void AnalysisThread::run() {
+    while(! threadShouldExit())
+        if(! processNextBlock())
+            wait(2);
+}
+
+/*
+ Pulls the next block out of the circular buffer and hands it to each stage in order, then tells the listeners
+ Returns false if nothing new had been written. Offline rendering calls this directly, without starting the thread
+ */
+bool AnalysisThread::processNextBlock() {
+    int numSamples = circBuffer->readFrom(block, readPosition, ANALYSIS_BLOCK_SIZE);
+    
+    if(numSamples == 0)
+        return false;
+    
+    const ScopedLock sl(stageLock);
+    const bool measuring = load->numOverlays.get() > 0;
+    const double blockStart = measuring ? Time::getMillisecondCounterHiRes() : 0.0;
+    
+    for(int i = 0; i < stages.size(); i++)
+        stages.getUnchecked(i)->process(block, numSamples);
+    
+    if(measuring) {
+        const float blockTime = (float) (Time::getMillisecondCounterHiRes() - blockStart);
+        load->blockTime = load->blockTime.get() + 0.1f * (blockTime - load->blockTime.get());
+        load->ringFill = (float) circBuffer->getNumUnread(readPosition) / (float) circBuffer->getSize();
+    }
+    
+    for(int i = 0; i < listeners.size(); i++)
+        listeners.getUnchecked(i)->analysisBlockProcessed();
+    
+    return true;
+}
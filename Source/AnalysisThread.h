@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    AnalysisThread.h
+    Created: 19 Oct 2026 10:12:41am
+    Author:  Esteban Cambronero
+    Background thread that streams audio out of the circular buffer into the analysis stages
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "CircularBuffer.h"
+#include "AnalysisStage.h"
+
+#define ANALYSIS_BLOCK_SIZE 1024
+
+/*
+ Load of the analysis thread published for the performance overlays, it is only measured while an overlay is shown
+ The block time is the smoothed time the stages take for a block, the ring fill how much of the circular buffer is waiting to be analysed
+ */
+struct AnalysisLoad {
+    AnalysisLoad() {
+        numOverlays = 0;
+        blockTime = 0.0f;
+        ringFill = 0.0f;
+    }
+    Atomic<int> numOverlays;
+    Atomic<float> blockTime;
+    Atomic<float> ringFill;
+};
+
+class AnalysisThread : public Thread
+{
+public:
+    /*
+     Told on the analysis thread after every block has been through the stages, e.g. to draw what they published
+     */
+    class Listener {
+    public:
+        virtual ~Listener() {}
+        virtual void analysisBlockProcessed() = 0;
+    };
+    AnalysisThread(CircularBuffer *circBuffer, double sampleRate);
+    ~AnalysisThread();
+    void addStage(AnalysisStage *stage);
+    void removeStage(AnalysisStage *stage);
+    void addListener(Listener *listener);
+    void removeListener(Listener *listener);
+    bool processNextBlock();
+    void run() override;
+private:
+    CircularBuffer *circBuffer;
+    double sampleRate;
+    int readPosition;
+    AudioBuffer<float> block;
+    
+    CriticalSection stageLock;
+    Array<AnalysisStage*> stages;
+    Array<Listener*> listeners;
+    SharedResourcePointer<AnalysisLoad> load;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalysisThread)
+};
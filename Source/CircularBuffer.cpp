@@ -31,11 +31,11 @@ void CircularBuffer::read(AudioBuffer<float> &toFill, int readSize) {
     if(readPos < 0)
         readPos = size + readPos;
     for(int i = 0; i < numChannels; i++) { //only applies if it needs to loop around the buffer
-        if(readPos + readSize > size - 1) {
+        if(readPos + readSize > size) {
                    int spotsLeft = size - readPos;
                    
                    toFill.copyFrom(i, 0, *(audioBuffer), i, readPos, spotsLeft);
-                   toFill.copyFrom(i, spotsLeft, *(audioBuffer), i, readPos + spotsLeft, readSize - spotsLeft);
+                   toFill.copyFrom(i, spotsLeft, *(audioBuffer), i, 0, readSize - spotsLeft);
                }
                else {
                    toFill.copyFrom(i, 0, *(audioBuffer), i, readPos, readSize);
@@ -46,22 +46,85 @@ void CircularBuffer::read(AudioBuffer<float> &toFill, int readSize) {
     tail = tail.get() % size;
 }
 
+/*
+    Streaming read for consumers that need every sample exactly once (e.g. the analysis thread).
+    Copies the samples written since readPosition (at most maxSamples) and advances readPosition,
+    returns the number of samples copied
+ */
+int CircularBuffer::readFrom(AudioBuffer<float> &toFill, int &readPosition, int maxSamples) {
+    int available = getNumUnread(readPosition);
+    int readSize = jmin(available, maxSamples, toFill.getNumSamples());
+    int channels = jmin(numChannels, toFill.getNumChannels());
+    
+    if(readSize <= 0)
+        return 0;
+    
+    for(int i = 0; i < channels; i++) {
+        if(readPosition + readSize > size) { //only applies if it needs to loop around the buffer
+            int spotsLeft = size - readPosition;
+            
+            toFill.copyFrom(i, 0, *(audioBuffer), i, readPosition, spotsLeft);
+            toFill.copyFrom(i, spotsLeft, *(audioBuffer), i, 0, readSize - spotsLeft);
+        }
+        else {
+            toFill.copyFrom(i, 0, *(audioBuffer), i, readPosition, readSize);
+        }
+    }
+    readPosition = (readPosition + readSize) % size;
+    return readSize;
+}
+
+/*
+    Returns how many samples have been written since readPosition and not read yet
+ */
+int CircularBuffer::getNumUnread(int readPosition) const {
+    int available = head.get() - readPosition;
+    
+    if(available < 0)
+        available += size;
+    
+    return available;
+}
+
 /*
     Write function for circular buffer that writes audio into the buffer from another audio buffer
  */
 void CircularBuffer::write(AudioBuffer<float> &newAudio, int start, int samples) {
-    for(int i = 0; i < numChannels; i++) {
-        int curr = head.get();
-        if(curr + samples > size - 1) {  //only applies if it needs to loop around the buffer
+    int curr = head.get();
+    int channels = jmin(numChannels, newAudio.getNumChannels());
+    
+    for(int i = 0; i < channels; i++) {
+        if(curr + samples > size) {  //only applies if it needs to loop around the buffer
             int spotsLeft = size - curr;
             
-            audioBuffer->copyFrom(i, curr, newAudio, i, start, samples);
+            audioBuffer->copyFrom(i, curr, newAudio, i, start, spotsLeft);
             audioBuffer->copyFrom(i, 0, newAudio, i, start + spotsLeft, samples - spotsLeft);
         }
         else {
             audioBuffer->copyFrom(i, curr, newAudio, i, start, samples);
         }
-        head += samples;
-        head = head.get() % size;
     }
+    // Only publish the new head once every channel has been written
+    head = (curr + samples) % size;
+}
+
+/*
+    Returns the position the next write will start at
+ */
+int CircularBuffer::getWritePosition() const {
+    return head.get();
+}
+
+/*
+    Returns the number of channels held by the buffer
+ */
+int CircularBuffer::getNumChannels() const {
+    return numChannels;
+}
+
+/*
+    Returns the capacity of the buffer in samples
+ */
+int CircularBuffer::getSize() const {
+    return size;
 }
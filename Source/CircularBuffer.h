@@ -17,6 +17,11 @@ public:
     CircularBuffer(int numChannels, int size);
     void write(AudioBuffer<float> &newAudio, int start, int samples);
     void read(AudioBuffer<float> &toFill, int readSize);
+    int readFrom(AudioBuffer<float> &toFill, int &readPosition, int maxSamples);
+    int getNumUnread(int readPosition) const;
+    int getWritePosition() const;
+    int getNumChannels() const;
+    int getSize() const;
 private:
     int numChannels;
     int size;
@@ -9,33 +9,72 @@
  */
 
 #include "CircularMesh.h"
+
+#ifndef GL_PRIMITIVE_RESTART
+ #define GL_PRIMITIVE_RESTART 0x8F9D
+#endif
+#ifndef GL_TEXTURE_2D_ARRAY
+ #define GL_TEXTURE_2D_ARRAY 0x8C1A
+#endif
+#ifndef GL_R16
+ #define GL_R16 0x822A
+#endif
+
+// Ends one triangle strip in the surface's index buffer and starts the next
+static const GLuint surfaceRestartIndex = 0xffffffff;
+
+// How far the bus's bins are stretched towards the low end across the grid
+static const float busBinSkew = 0.2f;
+
 /*
- Constructor for circular mesh takes in a circular buffer and a string as parameters
+ Constructor for circular mesh takes in the render host, a circular buffer and a string as parameters
+ The mesh adds itself to the host as a hidden pass
  */
-CircularMesh::CircularMesh(CircularBuffer *buffer, std::string type) : readBuffer(2, CIRC_BUFFER_READ_SIZE), forwardFFT(fftOrder)
+CircularMesh::CircularMesh(RenderHost &host, CircularBuffer *buffer, std::string type) : RenderPass(host)
 {
     meshType = type;
-    gLContext.setOpenGLVersionRequired(OpenGLContext::openGL3_2);
+    if(meshType == "circle")
+        meshShape = CIRCLE_SHAPE;
+    else if(meshType == "triangle")
+        meshShape = TRIANGLE_SHAPE;
+    else if(meshType == "line")
+        meshShape = LINE_SHAPE;
+    else
+        meshShape = SQUARE_SHAPE;
+    spectrumSource = nullptr;
+    layerMode = SINGLE_LAYER;
+    drawMode = POINTS_MODE;
+    resolution = MESH_DEFAULT_RESOLUTION;
+    benchmarkRequested = 0;
+    benchmarkStep = -1;
+    lastFrameStart = 0.0;
+    adaptiveDetail = 1;
+    frameBudget = MESH_DEFAULT_FRAME_BUDGET;
+    builtResolution = 0;
+    activeLevel = 0;
+    overlayShown = false;
+    numLayers = 0;
+    textureBins = 0;
+    drawnVersion = 0;
     circBuffer = buffer;
     
     draggableOrientation.reset(Vector3D<float>(0.0,1.0,0.0));
     
     fftData = new GLfloat[2*fftSize];
     
-    gLContext.setRenderer(this);
-    gLContext.attachTo(*this);
-    
     addAndMakeVisible(statusLabel);
     statusLabel.setJustificationType(Justification::topLeft);
     statusLabel.setFont(Font(14.0f));
+    statusLabel.setInterceptsMouseClicks(false, false);
+    
+    renderHost.addPass(this);
 }
 
 /*
  Destructor for circular mesh
  */
 CircularMesh::~CircularMesh() {
-    gLContext.setContinuousRepainting(false);
-    gLContext.detach();
+    renderHost.removePass(this);
     
     delete[] fftData;
     
@@ -43,52 +82,108 @@ CircularMesh::~CircularMesh() {
 }
 
 /*
- Start function that allows for continious repainting which calls the renderOpenGL function
+ Draws the spectrum published by an analysis stage instead of the shared spectrum bus, nullptr goes back to the bus
+ */
+void CircularMesh::setSpectrumSource(SpectrumSource *source) {
+    spectrumSource = source;
+}
+
+/*
+ Chooses how the spectra of the separate channels are laid out, a single layer shows the channels summed
+ */
+void CircularMesh::setLayerMode(LayerMode mode) {
+    layerMode = mode;
+}
+
+/*
+ Chooses between drawing the grid as points or as a shaded surface of triangles
+ */
+void CircularMesh::setDrawMode(DrawMode mode) {
+    drawMode = mode;
+}
+
+/*
+ Sets the number of points across the grid, the history is one row longer so the grid has a centre row
+ The grid is rebuilt by the next frame, so the history starts again from empty
+ */
+void CircularMesh::setResolution(int gridResolution) {
+    resolution = jlimit(2, MESH_MAX_RESOLUTION, gridResolution);
+}
+
+/*
+ Lets the mesh draw fewer points than its resolution while frames cost more than the budget, it goes back up when there is room
  */
-void CircularMesh::start() {
-    gLContext.setContinuousRepainting(true);
+void CircularMesh::setAdaptiveDetail(bool shouldAdapt) {
+    adaptiveDetail = shouldAdapt ? 1 : 0;
 }
 
 /*
- Stops the mesh from animating
+ Time a frame of the mesh may take on the CPU or the GPU before the detail is lowered
  */
-void CircularMesh::stop() {
-    gLContext.setContinuousRepainting(false);
+void CircularMesh::setFrameBudget(float milliseconds) {
+    frameBudget = jmax(0.1f, milliseconds);
+}
+
+/*
+ Shows the frame timings, the analysis load and the ring's fill level under the shader's status, a few times a second
+ Nothing is measured while it is hidden
+ */
+void CircularMesh::setPerformanceOverlay(bool shouldShow) {
+    overlayShown = shouldShow;
+    frameStats.setEnabled(shouldShow);
+    
+    if (! shouldShow)
+        showStatus (String());
 }
 
 /*
- Creates new OpenGL context which handles all of the visuals
+ Times the surface at every resolution from the default one up to the largest, the results are shown in the status label
+ The mesh goes back to its own draw mode and resolution afterwards
+ */
+void CircularMesh::startBenchmark() {
+    benchmarkRequested = 1;
+    gLContext.triggerRepaint();
+}
+
+/*
+ Creates the mesh's buffers and shaders in the host's context the first time the mesh is drawn
  */
 void CircularMesh::newOpenGLContextCreated() {
     xWidth = 3.0f;
     yHeight = 1.0f;
     zDepth = 3.0f;
-    xRes = 80;
-    zRes = 81;
-    numVertices = xRes * zRes;
+    builtResolution = 0;
+    activeLevel = 0;
     
-    initializeGridVertices();
+    numLayers = 0;
+    textureBins = 0;
+    textureSkew = busBinSkew;
     
-    initializeVertVertices();
+    // Core since OpenGL 1.2, but not exported on every platform
+    texImage3D = (TexImage3DFunction) OpenGLHelpers::getExtensionFunction ("glTexImage3D");
+    texSubImage3D = (TexSubImage3DFunction) OpenGLHelpers::getExtensionFunction ("glTexSubImage3D");
+    
+    // The heights only live in 3D textures, so without them the mesh says why in its status and draws nothing
+    VAO = 0;
+    
+    if (texImage3D == nullptr || texSubImage3D == nullptr)
+    {
+        postStatus ("OpenGL: glTexImage3D is not available, the mesh needs 3D textures", false);
+        return;
+    }
     
-    gLContext.extensions.glGenBuffers (1, &xzVBO); // Vertex Buffer Object
-    gLContext.extensions.glBindBuffer (GL_ARRAY_BUFFER, xzVBO);
-    gLContext.extensions.glBufferData (GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices * 2, xzVertices, GL_STATIC_DRAW);
+    // Core since OpenGL 3.2, without it every point is drawn and the shader hides the ones outside the shape
+    drawElementsBaseVertex = (DrawElementsBaseVertexFunction) OpenGLHelpers::getExtensionFunction ("glDrawElementsBaseVertex");
     
+    // Core since OpenGL 3.1, without it surfaces are drawn as points
+    primitiveRestartIndex = (PrimitiveRestartIndexFunction) OpenGLHelpers::getExtensionFunction ("glPrimitiveRestartIndex");
     
-    gLContext.extensions.glGenBuffers (1, &yVBO);
-    gLContext.extensions.glBindBuffer (GL_ARRAY_BUFFER, yVBO);
-    gLContext.extensions.glBufferData (GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices, yVertices, GL_STREAM_DRAW);
+    gpuTimer.create();
+    averageCost = 0.0;
     
     gLContext.extensions.glGenVertexArrays(1, &VAO);
-    gLContext.extensions.glBindVertexArray(VAO);
-    gLContext.extensions.glBindBuffer (GL_ARRAY_BUFFER, xzVBO);
-    gLContext.extensions.glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), NULL);
-    gLContext.extensions.glBindBuffer (GL_ARRAY_BUFFER, yVBO);
-    gLContext.extensions.glVertexAttribPointer (1, 1, GL_FLOAT, GL_FALSE, sizeof(GLfloat), NULL);
     
-    gLContext.extensions.glEnableVertexAttribArray (0);
-    gLContext.extensions.glEnableVertexAttribArray (1);
+    updateGridBuffers (1, SPECTRUM_BUS_NUM_BINS, resolution.get());
     
     glPointSize (3.0f);
     
@@ -97,25 +192,44 @@ void CircularMesh::newOpenGLContextCreated() {
 }
 
 /*
- Deallocates memory when openGL context is closed
+ Deallocates memory when the mesh leaves the host or the host's context is closed
  */
 void CircularMesh::openGLContextClosing() {
-    shader->release();
+    if (shader != nullptr)
+        shader->release();
+    
     shader = nullptr;
     uniforms = nullptr;
     
-    delete xzVertices;
-    delete yVertices;
+    // The context outlives the mesh, so its objects have to be deleted by hand
+    if (VAO != 0)
+        gLContext.extensions.glDeleteVertexArrays (1, &VAO);
+    
+    VAO = 0;
+    releaseDetailLevels();
+    gpuTimer.release();
+    
+    numLayers = 0;
+    textureBins = 0;
+    builtResolution = 0;
 }
 
 /*
  Renders the continiously updated graphics from the FFT data
  */
 void CircularMesh::renderOpenGL() {
-    const float renderingScale = (float) gLContext.getRenderingScale();
-    glViewport (0, 0, roundToInt (renderingScale * getWidth()), roundToInt (renderingScale * getHeight()));
+    // Set up failed or the shaders did not compile, the status label already says why
+    if (shader == nullptr)
+    {
+        OpenGLHelpers::clear (getLookAndFeel().findColour (ResizableWindow::backgroundColourId));
+        return;
+    }
     
-    // Set background Color
+    const double frameStart = Time::getMillisecondCounterHiRes();
+    const bool measuring = frameStats.beginFrame (renderHost.getFrameInterval());
+    gpuTimer.begin();
+    
+    // Set background Color, the host has already set the viewport and scissor to the mesh
     OpenGLHelpers::clear (getLookAndFeel().findColour (ResizableWindow::backgroundColourId));
     
     // Enable Alpha Blending
@@ -124,46 +238,69 @@ void CircularMesh::renderOpenGL() {
     
     shader->use();
     
-    circBuffer->read (readBuffer, CIRC_BUFFER_READ_SIZE);
-    FloatVectorOperations::clear (fftData, CIRC_BUFFER_READ_SIZE);
+    // Published spectra are mono, so they always use a single layer
+    SpectrumSource *source = spectrumSource.get();
+    const int mode = layerMode.get();
+    const int layers = (source != nullptr || mode == SINGLE_LAYER) ? 1 : jmin (circBuffer->getNumChannels(), MESH_MAX_LAYERS);
+    const int gridResolution = resolution.get();
+    
+    // A published spectrum is read first, the texture is as wide as its number of bins
+    int bins = SPECTRUM_BUS_NUM_BINS;
+    int numSourceBins = 0;
     
+    frameStats.beginStage();
     
-    for (int i = 0; i < 2; ++i)
+    if (source != nullptr)
     {
-        FloatVectorOperations::add (fftData, readBuffer.getReadPointer(i, 0), CIRC_BUFFER_READ_SIZE);
+        // The source's count is not trusted further than the bins it reports and the space in fftData
+        numSourceBins = jlimit (0, jmin (source->getNumBins(), 2 * fftSize), source->readSpectrum (fftData, 2 * fftSize));
+        bins = numSourceBins > 0 ? numSourceBins : jmax (1, textureBins);
     }
     
-    forwardFFT.performFrequencyOnlyForwardTransform (fftData);
+    frameStats.endStage (FrameStats::RING_READ_STAGE);
+    
+    if (layers != numLayers || bins != textureBins || gridResolution != builtResolution)
+        updateGridBuffers (layers, bins, gridResolution);
+    
+    const bool surface = drawMode.get() == SURFACE_MODE && drawElementsBaseVertex != nullptr && primitiveRestartIndex != nullptr;
     
-    // Find the range of values produced, so we can scale our rendering to
-    // show up the detail clearly
-    Range<float> maxFFTLevel = FloatVectorOperations::findMinAndMax (fftData, fftSize / 2);
+    // Compute the new row and push it into the history in place of the oldest one, repaints without new bus
+    // analysis such as dragging the mesh or the benchmark leave the history as it is
+    frameStats.beginStage();
+    bool newRowReady = true;
     
-    // Calculate new y values and shift old y values back
-    for (int i = numVertices; i >= 0; --i)
+    if (source != nullptr)
     {
-        // For the first row of points, render the new height via the FFT
-        if (i < xRes)
-        {
-            const float skewedProportionY = 1.0f - std::exp (std::log (i / ((float) xRes - 1.0f)) * 0.2f);
-            const int fftDataIndex = jlimit (0, fftSize / 2, (int) (skewedProportionY * fftSize / 2));
-            float level = 0.0f;
-            
-            if (maxFFTLevel.getEnd() != 0.0f)
-                level = jmap (fftData[fftDataIndex], 0.0f, maxFFTLevel.getEnd(), 0.0f, yHeight);
-            yVertices[i] = level;
-        }
-        else // For the subsequent rows, shift back
-        {
-            yVertices[i] = yVertices[i - xRes];
-        }
+        computeRowFromSource (numSourceBins);
+        textureSkew = 0.0f;
+        drawnVersion = 0;
+    }
+    else
+    {
+        newRowReady = computeRowFromBus();
+        textureSkew = busBinSkew;
     }
     
-    gLContext.extensions.glBindBuffer (GL_ARRAY_BUFFER, yVBO);
-    gLContext.extensions.glBufferData (GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices, yVertices, GL_STREAM_DRAW);
+    if (newRowReady)
+        yHistory.pushRow (newRow);
+    
+    frameStats.endStage (FrameStats::RING_READ_STAGE);
+    
+    // Every level's ring gets the newest row, so whichever level is drawn next already has its whole history
+    frameStats.beginStage();
+    
+    if (newRowReady)
+        for (DetailLevel &detailLevel : detailLevels)
+            uploadNewestRow (detailLevel);
+    
+    frameStats.endStage (FrameStats::UPLOAD_STAGE);
+    
+    const DetailLevel &level = detailLevels.getReference (activeLevel);
     
     
     // Setup the Uniforms for use in the Shader
+    frameStats.beginStage();
+    
     if (uniforms->projectionMatrix != nullptr)
         uniforms->projectionMatrix->setMatrix4 (getProjectionMatrix().mat, 1, false);
     
@@ -178,13 +315,294 @@ void CircularMesh::renderOpenGL() {
         
     }
     
-    // Draw the points
+    if (uniforms->layerMode != nullptr)
+        uniforms->layerMode->set ((GLint) mode);
+    if (uniforms->numLayers != nullptr)
+        uniforms->numLayers->set ((GLint) numLayers);
+    if (uniforms->rowLength != nullptr)
+        uniforms->rowLength->set ((GLint) level.xRes);
+    if (uniforms->rowSpacing != nullptr)
+        uniforms->rowSpacing->set (zDepth / ((GLfloat) level.zRes - 1.0f));
+    if (uniforms->gridWidth != nullptr)
+        uniforms->gridWidth->set (xWidth);
+    if (uniforms->heightScale != nullptr)
+        uniforms->heightScale->set (yHeight);
+    if (uniforms->ringOffset != nullptr)
+        uniforms->ringOffset->set ((GLint) level.newestRow);
+    if (uniforms->historyRows != nullptr)
+        uniforms->historyRows->set ((GLint) level.zRes);
+    if (uniforms->surface != nullptr)
+        uniforms->surface->set ((GLint) (surface ? 1 : 0));
+    if (uniforms->binCount != nullptr)
+        uniforms->binCount->set ((GLint) textureBins);
+    if (uniforms->binSkew != nullptr)
+        uniforms->binSkew->set (textureSkew);
+    
+    // The vertices are in display order and the shader finds each one's row in the ring, so the whole grid is one draw per layer
+    gLContext.extensions.glActiveTexture (GL_TEXTURE0);
+    glBindTexture (GL_TEXTURE_2D_ARRAY, level.heightTexture);
     gLContext.extensions.glBindVertexArray(VAO);
-    glDrawArrays (GL_POINTS, 0, numVertices);
     
+    if (drawElementsBaseVertex != nullptr)
+    {
+        if (surface)
+        {
+            glEnable (GL_DEPTH_TEST);
+            glEnable (GL_PRIMITIVE_RESTART);
+            primitiveRestartIndex (surfaceRestartIndex);
+            gLContext.extensions.glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, level.surfaceEBO);
+            drawShape (GL_TRIANGLE_STRIP, level.numSurfaceIndices, level.numVertices);
+            glDisable (GL_PRIMITIVE_RESTART);
+            glDisable (GL_DEPTH_TEST);
+        }
+        else
+        {
+            gLContext.extensions.glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, level.shapeEBO);
+            drawShape (GL_POINTS, level.numShapeIndices, level.numVertices);
+        }
+    }
+    else
+    {
+        glDrawArrays (GL_POINTS, 0, level.numVertices * numLayers);
+    }
+    
+    glBindTexture (GL_TEXTURE_2D_ARRAY, 0);
+    
+    frameStats.endStage (FrameStats::DRAW_STAGE);
+    gpuTimer.end();
+    updateDetailLevel (Time::getMillisecondCounterHiRes() - frameStart);
+    
+    if (measuring && frameStats.endFrame (gpuTimer))
+    {
+        const DetailLevel &shownLevel = detailLevels.getReference (activeLevel);
+        postStatus (frameStats.takeReport() + "\nDetail " + String (shownLevel.xRes) + " x " + String (shownLevel.zRes), true);
+    }
+    
+    updateBenchmark (frameStart);
+}
+
+/*
+ Shows text in the status label from the render thread, either the shader's status or a performance report to go under it
+ Reports that arrive after the overlay has been hidden are dropped
+ */
+void CircularMesh::postStatus(const String &text, bool isReport) {
+    Component::SafePointer<CircularMesh> mesh (this);
+    MessageManager::callAsync ([mesh, text, isReport] {
+        CircularMesh *target = mesh.getComponent();
+        
+        if (target == nullptr || (isReport && ! target->overlayShown))
+            return;
+        
+        if (! isReport)
+            target->shaderStatus = text;
+        
+        target->showStatus (isReport ? text : String());
+    });
+}
+
+/*
+ Shows a detail change or benchmark result from the render thread under the shader's status, until the next one replaces it
+ */
+void CircularMesh::postNotice(const String &text) {
+    Component::SafePointer<CircularMesh> mesh (this);
+    MessageManager::callAsync ([mesh, text] {
+        if (CircularMesh *target = mesh.getComponent())
+        {
+            target->statusNotice = text;
+            target->showStatus (String());
+        }
+    });
+}
+
+/*
+ Puts the shader's status, the notice and the performance report, if there is one, in the status label
+ */
+void CircularMesh::showStatus(const String &report) {
+    String text (shaderStatus);
+    
+    if (statusNotice.isNotEmpty())
+        text << "\n" << statusNotice;
+    if (report.isNotEmpty())
+        text << "\n" << report;
+    
+    statusLabel.setText (text, dontSendNotification);
+}
+
+/*
+ Moves the newest row of a level's ring back by one and copies the newest row of every layer into it, the layers of a
+ history row follow each other so one upload covers all of them
+ */
+void CircularMesh::uploadNewestRow(DetailLevel &level) {
+    level.newestRow = (level.newestRow + level.zRes - 1) % level.zRes;
+    
+    glBindTexture (GL_TEXTURE_2D_ARRAY, level.heightTexture);
+    glPixelStorei (GL_UNPACK_ALIGNMENT, 2);
+    texSubImage3D (GL_TEXTURE_2D_ARRAY, 0, 0, level.newestRow, 0, textureBins, 1, numLayers, GL_RED, GL_UNSIGNED_SHORT, yHistory.getRow (0));
+    glPixelStorei (GL_UNPACK_ALIGNMENT, 4);
+}
+
+/*
+ Moves to a coarser level when the frame cost has been over the budget for a while, and back to a finer one when it has
+ been well under for longer. A finer level costs up to four times as much, so the gap between the two keeps it from swinging
+ The benchmark always draws the full resolution
+ */
+void CircularMesh::updateDetailLevel(double cpuTime) {
+    int targetLevel = activeLevel;
+    
+    if (adaptiveDetail.get() == 0 || benchmarkStep >= 0)
+    {
+        targetLevel = 0;
+    }
+    else if (settleFrames > 0)
+    {
+        // The GPU timings are a few frames behind, so the ones from before the last change are left out
+        --settleFrames;
+        averageCost = 0.0;
+        return;
+    }
+    else
+    {
+        const double cost = jmax (cpuTime, gpuTimer.getLastMilliseconds());
+        const double budget = (double) frameBudget.get();
+        averageCost = averageCost > 0.0 ? averageCost + 0.1 * (cost - averageCost) : cost;
+        
+        overBudgetFrames = averageCost > budget ? overBudgetFrames + 1 : 0;
+        underBudgetFrames = averageCost < budget * MESH_DETAIL_RESTORE_FRACTION ? underBudgetFrames + 1 : 0;
+        
+        if (overBudgetFrames >= MESH_DETAIL_LOWER_FRAMES && activeLevel < detailLevels.size() - 1)
+            ++targetLevel;
+        else if (underBudgetFrames >= MESH_DETAIL_RESTORE_FRAMES && activeLevel > 0)
+            --targetLevel;
+    }
+    
+    if (targetLevel == activeLevel)
+        return;
+    
+    activeLevel = targetLevel;
+    overBudgetFrames = 0;
+    underBudgetFrames = 0;
+    settleFrames = GPU_TIMER_QUERIES + 1;
+    averageCost = 0.0;
+    
+    const DetailLevel &level = detailLevels.getReference (activeLevel);
+    postNotice ("Detail: " + String (level.xRes) + " x " + String (level.zRes));
+}
+
+/*
+ Times the frame while a benchmark runs, after enough frames at one resolution it moves on to the next
+ The render time includes waiting for the GPU to finish, the frame time is from the start of one frame to the next
+ */
+void CircularMesh::updateBenchmark(double frameStart) {
+    static const int benchmarkResolutions[] = { MESH_DEFAULT_RESOLUTION, 256, 512, 1024, MESH_MAX_RESOLUTION };
+    
+    const double frameTime = frameStart - lastFrameStart;
+    lastFrameStart = frameStart;
+    
+    if (benchmarkRequested.compareAndSetBool (0, 1))
+    {
+        benchmarkStep = 0;
+        benchmarkSavedResolution = resolution.get();
+        benchmarkSavedMode = drawMode.get();
+        benchmarkReport = "Surface frame times";
+        benchmarkFrames = -MESH_BENCHMARK_WARMUP_FRAMES;
+        benchmarkRenderTime = 0.0;
+        benchmarkFrameTime = 0.0;
+        drawMode = SURFACE_MODE;
+        resolution = benchmarkResolutions[0];
+        gLContext.triggerRepaint();
+        return;
+    }
+    
+    if (benchmarkStep < 0)
+        return;
+    
+    // Benchmark frames follow each other as fast as the swap interval allows, whatever the host's pacing
+    gLContext.triggerRepaint();
+    
+    glFinish();
+    const double renderTime = Time::getMillisecondCounterHiRes() - frameStart;
+    
+    // The first frames after the grid is rebuilt are left out
+    if (benchmarkFrames >= 0)
+    {
+        benchmarkRenderTime += renderTime;
+        benchmarkFrameTime += frameTime;
+    }
+    
+    if (++benchmarkFrames < MESH_BENCHMARK_FRAMES)
+        return;
+    
+    const int stepResolution = benchmarkResolutions[benchmarkStep];
+    benchmarkReport << "\n" << stepResolution << " x " << stepResolution + 1 << ": "
+                    << String (benchmarkFrameTime / MESH_BENCHMARK_FRAMES, 2) << " ms frame, "
+                    << String (benchmarkRenderTime / MESH_BENCHMARK_FRAMES, 2) << " ms render";
     
-    // Zero Out FFT for next use
-    zeromem (fftData, sizeof (GLfloat) * 2 * fftSize);
+    if (++benchmarkStep < numElementsInArray (benchmarkResolutions))
+    {
+        benchmarkFrames = -MESH_BENCHMARK_WARMUP_FRAMES;
+        benchmarkRenderTime = 0.0;
+        benchmarkFrameTime = 0.0;
+        resolution = benchmarkResolutions[benchmarkStep];
+        return;
+    }
+    
+    benchmarkStep = -1;
+    resolution = benchmarkSavedResolution;
+    drawMode = benchmarkSavedMode;
+    
+    Logger::writeToLog (benchmarkReport);
+    postNotice (benchmarkReport);
+}
+
+/*
+ Fills the first row of heights from the newest frame on the spectrum bus, scaled by the loudest bin so the detail shows up clearly
+ Returns false without touching the row when the bus has not moved on since the last row was computed
+ */
+bool CircularMesh::computeRowFromBus() {
+    if (spectrumBus->getLatestVersion() == drawnVersion)
+        return false;
+    
+    SpectrumBus::ScopedFrame frame (*spectrumBus);
+    const SpectrumBus::Frame *latest = frame.get();
+    
+    if (latest == nullptr)
+        return false;
+    
+    drawnVersion = latest->version;
+    
+    for (int layer = 0; layer < numLayers; ++layer)
+    {
+        float *bins = newRow + layer * textureBins;
+        
+        if (numLayers > 1 && layer >= latest->numChannels)
+        {
+            FloatVectorOperations::clear (bins, textureBins);
+            continue;
+        }
+        
+        // The top bin is left out of the scale, as the band map did
+        const float *magnitudes = numLayers == 1 ? latest->getMix() : latest->getChannel (layer);
+        const float maxLevel = FloatVectorOperations::findMaximum (magnitudes, textureBins - 1);
+        
+        if (maxLevel != 0.0f)
+            FloatVectorOperations::multiply (bins, magnitudes, yHeight / maxLevel, textureBins);
+        else
+            FloatVectorOperations::clear (bins, textureBins);
+    }
+    
+    return true;
+}
+
+/*
+ Fills the first row of heights from the published spectrum already read into fftData, its bins are spread evenly across the row
+ */
+void CircularMesh::computeRowFromSource(int numBins) {
+    const float maxLevel = numBins > 0 ? FloatVectorOperations::findMaximum (fftData, numBins) : 0.0f;
+    
+    if (maxLevel > 0.0f)
+        FloatVectorOperations::multiply (newRow, fftData, yHeight / maxLevel, textureBins);
+    else
+        FloatVectorOperations::clear (newRow, textureBins);
 }
 
 /*
@@ -197,7 +615,7 @@ void CircularMesh::paint(Graphics &g){}
  */
 void CircularMesh::resized() {
     draggableOrientation.setViewport(getLocalBounds());
-    statusLabel.setBounds(getLocalBounds().reduced(4).removeFromTop(75));
+    statusLabel.setBounds(getLocalBounds().reduced(4).removeFromTop(200));
 }
 
 /*
@@ -212,86 +630,182 @@ void CircularMesh::mouseDown(const MouseEvent &e) {
  */
 void CircularMesh::mouseDrag(const MouseEvent &e) {
     draggableOrientation.mouseDrag(e.getPosition());
+    
+    // The host may only be drawing for new analysis, so turning the mesh draws it straight away
+    gLContext.triggerRepaint();
 }
 
 /*
- Initializes the xz vertices for the mesh based on the meshtype
- */
-void CircularMesh::initializeGridVertices() {
-    int numFloatsXZ = numVertices * 2;
-    
-    xzVertices = new GLfloat [numFloatsXZ];
-    
-    // Variables when setting x and z
-    GLfloat xOffset = xWidth / ((GLfloat) xRes - 1.0f);
-    GLfloat zOffset = zDepth / ((GLfloat) zRes - 1.0f);
-    GLfloat xStart = -(xWidth / 2.0f);
-    GLfloat zStart = -(zDepth / 2.0f);
-    int xzIndex = 0;
-    if(meshType == "circle") {
-        int xCircleOffset = 0;
-        for(int col = 0; col < zRes; col++) {
-            xCircleOffset = sqrt((zRes/2)*(zRes/2) - (col - zRes/2)*(col - zRes/2));
-            for(int row = 0; row < xRes; row++) {
-                if(row - zRes/2 < xCircleOffset && row - zRes/2 > -xCircleOffset) {
-                    xzVertices[xzIndex] = xStart + xOffset * row;
-                    xzVertices[xzIndex + 1] = zStart + zOffset * col;
-                }
-                else {
-                    xzVertices[xzIndex] = -200;
-                    xzVertices[xzIndex + 1] = -200;
-                }
-                xzIndex +=2;
-            }
-        }
+ Rebuilds the height textures of every level for a new number of layers, bins or a new resolution
+ The levels' indices only depend on the grid, so they are only rebuilt when the resolution changes
+ */
+void CircularMesh::updateGridBuffers(int layers, int bins, int gridResolution) {
+    if (gridResolution != builtResolution)
+        createDetailLevels (gridResolution);
+    
+    numLayers = layers;
+    textureBins = bins;
+    
+    // All heights start at 0.0, only the newest row is kept on the CPU as the textures hold the history
+    yHistory.allocate (textureBins * numLayers, 1, 0.0f, yHeight);
+    newRow.allocate (textureBins * numLayers, true);
+    drawnVersion = 0;
+    
+    // Level 0 has the longest history, so its silence is enough for every level
+    HeapBlock<GLushort> heights ((size_t) textureBins * (size_t) detailLevels.getReference (0).zRes * (size_t) numLayers, true);
+    glPixelStorei (GL_UNPACK_ALIGNMENT, 2);
+    
+    for (DetailLevel &level : detailLevels)
+    {
+        level.newestRow = 0;
+        glBindTexture (GL_TEXTURE_2D_ARRAY, level.heightTexture);
+        texImage3D (GL_TEXTURE_2D_ARRAY, 0, GL_R16, textureBins, level.zRes, numLayers, 0, GL_RED, GL_UNSIGNED_SHORT, heights);
     }
-    else if(meshType == "line") {
-        for(int col = 0; col < zRes; col++) {
-            for(int row = 0; row < xRes; row++) {
-                xzVertices[xzIndex] = xStart + xOffset * row;
-                xzIndex +=2;
-            }
-        }
+    
+    glPixelStorei (GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture (GL_TEXTURE_2D_ARRAY, 0);
+}
+
+/*
+ Creates the texture and index buffers of every level for a new resolution, levels stop halving at the smallest detail resolution
+ The mesh starts again from the full resolution
+ */
+void CircularMesh::createDetailLevels(int gridResolution) {
+    releaseDetailLevels();
+    
+    builtResolution = gridResolution;
+    activeLevel = 0;
+    overBudgetFrames = 0;
+    underBudgetFrames = 0;
+    settleFrames = GPU_TIMER_QUERIES + 1;
+    gLContext.extensions.glBindVertexArray (VAO);
+    
+    for (int i = 0; i < MESH_DETAIL_LEVELS; ++i)
+    {
+        const int levelResolution = jmin (gridResolution, jmax (MESH_MIN_DETAIL_RESOLUTION, gridResolution >> i));
+        
+        if (i > 0 && levelResolution == detailLevels.getReference (i - 1).xRes)
+            break;
+        
+        DetailLevel level;
+        level.xRes = levelResolution;
+        level.zRes = levelResolution + 1;
+        level.numVertices = level.xRes * level.zRes;
+        level.newestRow = 0;
+        
+        glGenTextures (1, &level.heightTexture);
+        glBindTexture (GL_TEXTURE_2D_ARRAY, level.heightTexture);
+        glTexParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri (GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        
+        gLContext.extensions.glGenBuffers (1, &level.shapeEBO);
+        gLContext.extensions.glGenBuffers (1, &level.surfaceEBO);
+        buildShapeIndices (level);
+        buildSurfaceIndices (level);
+        
+        detailLevels.add (level);
     }
-    else if(meshType == "triangle") {
-        int topTriangleOffset = 0;
-        int bottomTriangleOffset = 0;
-        for(int col = 0; col < zRes; col++) {
-            bottomTriangleOffset = col/2;
-            topTriangleOffset = -col/2 + zRes;
-            for(int row = 0; row < xRes; row++) {
-                if(row >= bottomTriangleOffset && row <= topTriangleOffset) {
-                    xzVertices[xzIndex] = xStart + xOffset * row;
-                    xzVertices[xzIndex + 1] = zStart + zOffset * col;
-                }
-                else {
-                    xzVertices[xzIndex] = -200;
-                    xzVertices[xzIndex + 1] = -200;
-                }
-                xzIndex +=2;
-            }
-        }
+    
+    glBindTexture (GL_TEXTURE_2D_ARRAY, 0);
+}
+
+/*
+ Deletes the texture and index buffers of every level
+ */
+void CircularMesh::releaseDetailLevels() {
+    for (DetailLevel &level : detailLevels)
+    {
+        glDeleteTextures (1, &level.heightTexture);
+        gLContext.extensions.glDeleteBuffers (1, &level.shapeEBO);
+        gLContext.extensions.glDeleteBuffers (1, &level.surfaceEBO);
+    }
+    
+    detailLevels.clear();
+}
+
+/*
+ Whether a point of the grid is part of the mesh's shape, must match the test in the vertex shader
+ Circles keep the points within the radius of the grid's centre, triangles narrow by one point every two rows
+ */
+bool CircularMesh::isInShape(int row, int age, int historyRows) const {
+    const int centre = historyRows / 2;
+    
+    if (meshShape == CIRCLE_SHAPE)
+    {
+        const int offset = std::abs (row - centre) + 1;
+        return offset * offset <= centre * centre - (age - centre) * (age - centre);
     }
-    else if(meshType == "square") {
-        for(int col = 0; col < zRes; col++) {
-            for(int row = 0; row < xRes; row++) {
-                xzVertices[xzIndex] = xStart + xOffset * row;
-                xzVertices[xzIndex + 1] = zStart + zOffset * col;
-                xzIndex +=2;
+    if (meshShape == TRIANGLE_SHAPE)
+        return row >= age / 2 && row <= historyRows - age / 2;
+    return true;
+}
+
+/*
+ Collects the points inside the shape into a level's shape index buffer, one history row after another
+ */
+void CircularMesh::buildShapeIndices(DetailLevel &level) {
+    const int xRes = level.xRes;
+    const int zRes = level.zRes;
+    HeapBlock<GLuint> indices ((size_t) xRes * (size_t) zRes);
+    int numIndices = 0;
+    
+    for (int age = 0; age < zRes; ++age)
+        for (int row = 0; row < xRes; ++row)
+            if (isInShape (row, age, zRes))
+                indices[numIndices++] = (GLuint) (age * xRes + row);
+    
+    level.numShapeIndices = numIndices;
+    gLContext.extensions.glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, level.shapeEBO);
+    gLContext.extensions.glBufferData (GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * numIndices, indices, GL_STATIC_DRAW);
+}
+
+/*
+ Collects a triangle strip along every run of points that are inside the shape in two neighbouring history rows of a level
+ */
+void CircularMesh::buildSurfaceIndices(DetailLevel &level) {
+    const int xRes = level.xRes;
+    const int zRes = level.zRes;
+    HeapBlock<GLuint> indices ((size_t) (zRes - 1) * (size_t) (3 * xRes));
+    int numIndices = 0;
+    
+    for (int age = 0; age < zRes - 1; ++age)
+    {
+        int stripStart = numIndices;
+        
+        for (int row = 0; row <= xRes; ++row)
+        {
+            if (row < xRes && isInShape (row, age, zRes) && isInShape (row, age + 1, zRes))
+            {
+                indices[numIndices++] = (GLuint) (age * xRes + row);
+                indices[numIndices++] = (GLuint) ((age + 1) * xRes + row);
+                continue;
             }
+            
+            // A strip needs two points in each row to make a triangle, shorter ones are dropped
+            if (numIndices - stripStart >= 4)
+                indices[numIndices++] = surfaceRestartIndex;
+            else
+                numIndices = stripStart;
+            stripStart = numIndices;
         }
     }
+    
+    level.numSurfaceIndices = numIndices;
+    gLContext.extensions.glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, level.surfaceEBO);
+    gLContext.extensions.glBufferData (GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * numIndices, indices, GL_STATIC_DRAW);
 }
 
 /*
- Initializes vertical vertices for the visualizer
- Made easy because of how the xz vertices are setup
+ Draws the bound index buffer once for every layer, the base vertex tells the shader which layer it is drawing
  */
-void CircularMesh::initializeVertVertices()
-{
-    // Set all Y values to 0.0
-    yVertices = new GLfloat [numVertices];
-    memset(yVertices, 0.0f, sizeof(GLfloat) * xRes * zRes);
+void CircularMesh::drawShape(GLenum primitive, int numIndices, int layerVertices) {
+    if (numIndices <= 0)
+        return;
+    
+    for (int layer = 0; layer < numLayers; ++layer)
+        drawElementsBaseVertex (primitive, numIndices, GL_UNSIGNED_INT, nullptr, layer * layerVertices);
 }
 
 /*
@@ -319,25 +833,107 @@ Matrix3D<float> CircularMesh::getViewMatrix() const {
 void CircularMesh::createShaders() {
     VERTEX_SHADER =
     "#version 330 core\n"
-    "layout (location = 0) in vec2 xzPos;\n"
-    "layout (location = 1) in float yPos;\n"
     // Uniforms
     "uniform mat4 projectionMatrix;\n"
     "uniform mat4 viewMatrix;\n"
+    "uniform int layerMode;\n"
+    "uniform int numLayers;\n"
+    "uniform int rowLength;\n"
+    "uniform float rowSpacing;\n"
+    "uniform float gridWidth;\n"
+    "uniform float heightScale;\n"
+    "uniform int ringOffset;\n"
+    "uniform int historyRows;\n"
+    "uniform int shape;\n"
+    "uniform sampler2DArray heights;\n"
+    "uniform int binCount;\n"
+    "uniform float binSkew;\n"
+    "uniform int surface;\n"
+    "out float layerShade;\n"
+    "out vec3 viewNormal;\n"
+    "\n"
+    // Columns are spread over the bins as the band map did, but the texture filters between neighbouring bins
+    "float heightAt(int row, int age, float layer)\n"
+    "{\n"
+    "    float proportion = float(row) / float(rowLength - 1);\n"
+    "    float bin = (binSkew > 0.0f ? 1.0f - pow(proportion, binSkew) : proportion) * float(binCount - 1);\n"
+    "    float slot = float((age + ringOffset) % historyRows);\n"
+    "    return texture(heights, vec3((bin + 0.5f) / float(binCount), (slot + 0.5f) / float(historyRows), layer)).r * heightScale;\n"
+    "}\n"
     "\n"
     "void main()\n"
     "{\n"
-    "    gl_Position = projectionMatrix * viewMatrix * vec4(xzPos[0], yPos, xzPos[1], 1.0f);\n"
+    // The vertices of each layer are in display order, the height texture is a ring of history rows with the newest at ringOffset
+    "    int layerLength = historyRows * rowLength;\n"
+    "    float layer = float(gl_VertexID / layerLength);\n"
+    "    float layers = float(numLayers);\n"
+    "    int age = (gl_VertexID % layerLength) / rowLength;\n"
+    "    int row = gl_VertexID % rowLength;\n"
+    // Circles keep the points within the radius of the grid's centre, triangles narrow by one point every two rows
+    "    int centre = historyRows / 2;\n"
+    "    int offset = abs(row - centre) + 1;\n"
+    "    bool visible = true;\n"
+    "    if (shape == 1)\n"
+    "        visible = offset * offset <= centre * centre - (age - centre) * (age - centre);\n"
+    "    else if (shape == 2)\n"
+    "        visible = row >= age / 2 && row <= historyRows - age / 2;\n"
+    // Points outside the shape are put outside the clip volume so nothing else is done for them
+    "    if (! visible)\n"
+    "    {\n"
+    "        layerShade = 0.0f;\n"
+    "        viewNormal = vec3(0.0f, 1.0f, 0.0f);\n"
+    "        gl_Position = vec4(0.0f, 0.0f, 2.0f, 1.0f);\n"
+    "        return;\n"
+    "    }\n"
+    "    float x = (float(row) / float(rowLength - 1) - 0.5f) * gridWidth;\n"
+    "    float z = shape == 3 ? 0.0f : (float(age) - 0.5f * float(historyRows - 1)) * rowSpacing;\n"
+    "    vec3 position = vec3(x, heightAt(row, age, layer), z);\n"
+    // Interleaved layers sit between each other's rows, stacked layers share the height, split layers share the width
+    "    if (layerMode == 2)\n"
+    "        position.z += layer * rowSpacing / layers;\n"
+    "    else if (layerMode == 3)\n"
+    "        position.y = (position.y + layer) / layers;\n"
+    "    else if (layerMode == 4)\n"
+    "        position.x = (position.x + 0.5f * gridWidth + layer * gridWidth) / layers - 0.5f * gridWidth;\n"
+    // Surfaces are lit by a normal from central differences of the neighbouring heights, one sided at the grid's edges,
+    // scaled the same way as the layer modes scale the positions. Lines have every row at the same depth so only slope across
+    "    viewNormal = vec3(0.0f, 1.0f, 0.0f);\n"
+    "    if (surface == 1)\n"
+    "    {\n"
+    "        int left = max(row - 1, 0);\n"
+    "        int right = min(row + 1, rowLength - 1);\n"
+    "        int newer = max(age - 1, 0);\n"
+    "        int older = min(age + 1, historyRows - 1);\n"
+    "        float widthScale = layerMode == 4 ? 1.0f / layers : 1.0f;\n"
+    "        float heightScaling = layerMode == 3 ? 1.0f / layers : 1.0f;\n"
+    "        float across = float(right - left) * gridWidth / float(rowLength - 1) * widthScale;\n"
+    "        float along = float(older - newer) * rowSpacing;\n"
+    "        float slopeX = (heightAt(right, age, layer) - heightAt(left, age, layer)) * heightScaling / across;\n"
+    "        float slopeZ = shape == 3 || older == newer ? 0.0f : (heightAt(row, older, layer) - heightAt(row, newer, layer)) * heightScaling / along;\n"
+    "        viewNormal = mat3(viewMatrix) * vec3(-slopeX, 1.0f, -slopeZ);\n"
+    "    }\n"
+    "    layerShade = numLayers > 1 ? layer / (layers - 1.0f) : 0.0f;\n"
+    "    gl_Position = projectionMatrix * viewMatrix * vec4(position, 1.0f);\n"
     "}\n";
     
     
     // Base Shader
     FRAGMENT_SHADER =
     "#version 330 core\n"
+    "in float layerShade;\n"
+    "in vec3 viewNormal;\n"
+    "uniform int surface;\n"
     "out vec4 color;\n"
     "void main()\n"
     "{\n"
-    "    color = vec4 (0.0f, 0.749f, 1.0f, 1.0f);\n"
+    "    vec3 base = mix (vec3 (0.0f, 0.749f, 1.0f), vec3 (1.0f, 0.4f, 0.7f), layerShade);\n"
+    // The normal is interpolated from the vertices, so the light changes smoothly over each strip
+    "    if (surface == 1)\n"
+    "    {\n"
+    "        float diffuse = max (dot (normalize (viewNormal), normalize (vec3 (0.3f, 0.8f, 0.5f))), 0.0f);\n"
+    "        base *= 0.3f + 0.7f * diffuse;\n"
+    "    }\n"
+    "    color = vec4 (base, 1.0f);\n"
     "}\n";
     
     
@@ -355,12 +951,20 @@ void CircularMesh::createShaders() {
         
         uniforms   = new Uniforms (gLContext, *shader);
         
+        // The shape and texture unit never change, so they are set once while the program is in use
+        if (uniforms->shape != nullptr)
+            uniforms->shape->set ((GLint) meshShape);
+        if (uniforms->heights != nullptr)
+            uniforms->heights->set ((GLint) 0);
+        
         statusText = "GLSL: v" + String (OpenGLShaderProgram::getLanguageVersion(), 2);
     }
     else
     {
         statusText = newShader->getLastError();
     }
+    
+    postStatus (statusText, false);
 }
 
 /*
@@ -369,6 +973,19 @@ void CircularMesh::createShaders() {
 CircularMesh::Uniforms::Uniforms(OpenGLContext& context, OpenGLShaderProgram& shaders) {
     projectionMatrix = createUniform(context, shaders, "projectionMatrix");
     viewMatrix = createUniform(context, shaders, "viewMatrix");
+    layerMode = createUniform(context, shaders, "layerMode");
+    numLayers = createUniform(context, shaders, "numLayers");
+    rowLength = createUniform(context, shaders, "rowLength");
+    rowSpacing = createUniform(context, shaders, "rowSpacing");
+    gridWidth = createUniform(context, shaders, "gridWidth");
+    heightScale = createUniform(context, shaders, "heightScale");
+    ringOffset = createUniform(context, shaders, "ringOffset");
+    historyRows = createUniform(context, shaders, "historyRows");
+    shape = createUniform(context, shaders, "shape");
+    surface = createUniform(context, shaders, "surface");
+    heights = createUniform(context, shaders, "heights");
+    binCount = createUniform(context, shaders, "binCount");
+    binSkew = createUniform(context, shaders, "binSkew");
 }
 /*
 Creates the uniform based on the name using OpenGL libraries
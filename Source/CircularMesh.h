@@ -11,16 +11,55 @@
 #pragma once
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "CircularBuffer.h"
+#include "AnalysisNodes.h"
+#include "SpectrumBus.h"
+#include "SpectrumSource.h"
+#include "SpectralHistory.h"
+#include "RenderHost.h"
+#include "GpuTimer.h"
+#include "FrameStats.h"
 
-#define CIRC_BUFFER_READ_SIZE 256
+#define MESH_MAX_LAYERS 8
+#define MESH_DEFAULT_RESOLUTION 80
+#define MESH_MAX_RESOLUTION 2048
+#define MESH_BENCHMARK_WARMUP_FRAMES 10
+#define MESH_BENCHMARK_FRAMES 120
+#define MESH_DETAIL_LEVELS 3
+#define MESH_MIN_DETAIL_RESOLUTION 32
+#define MESH_DEFAULT_FRAME_BUDGET 8.0f
+#define MESH_DETAIL_LOWER_FRAMES 15
+#define MESH_DETAIL_RESTORE_FRAMES 120
+#define MESH_DETAIL_RESTORE_FRACTION 0.3
 
-class CircularMesh : public Component, public OpenGLRenderer
+class CircularMesh : public RenderPass
 {
 public:
-    CircularMesh(CircularBuffer *circBuffer, std::string type);
+    enum MeshShape {
+        SQUARE_SHAPE,
+        CIRCLE_SHAPE,
+        TRIANGLE_SHAPE,
+        LINE_SHAPE
+    };
+    enum LayerMode {
+        SINGLE_LAYER = 1,
+        INTERLEAVED_LAYERS,
+        STACKED_LAYERS,
+        SPLIT_LAYERS
+    };
+    enum DrawMode {
+        POINTS_MODE = 1,
+        SURFACE_MODE
+    };
+    CircularMesh(RenderHost &host, CircularBuffer *circBuffer, std::string type);
     ~CircularMesh();
-    void start();
-    void stop();
+    void setSpectrumSource(SpectrumSource *source);
+    void setLayerMode(LayerMode mode);
+    void setDrawMode(DrawMode mode);
+    void setResolution(int gridResolution);
+    void setAdaptiveDetail(bool shouldAdapt);
+    void setFrameBudget(float milliseconds);
+    void setPerformanceOverlay(bool shouldShow);
+    void startBenchmark();
     void newOpenGLContextCreated() override;
     void openGLContextClosing() override;
     void renderOpenGL() override;
@@ -29,33 +68,83 @@ public:
     void mouseDown(const MouseEvent &e) override;
     void mouseDrag(const MouseEvent &e) override;
 private:
+    /*
+     A grid of one resolution with everything needed to draw it, every level is kept up to date so switching is free
+     */
+    struct DetailLevel {
+        int xRes;
+        int zRes;
+        int numVertices;
+        int newestRow;
+        GLuint heightTexture;
+        GLuint shapeEBO;
+        GLuint surfaceEBO;
+        int numShapeIndices;
+        int numSurfaceIndices;
+    };
     void drawGridType();
-    void initializeGridVertices();
-    void initializeVertVertices();
+    void updateGridBuffers(int layers, int bins, int gridResolution);
+    void createDetailLevels(int gridResolution);
+    void releaseDetailLevels();
+    void uploadNewestRow(DetailLevel &level);
+    bool isInShape(int row, int age, int historyRows) const;
+    void buildShapeIndices(DetailLevel &level);
+    void buildSurfaceIndices(DetailLevel &level);
+    void drawShape(GLenum primitive, int numIndices, int layerVertices);
+    void updateDetailLevel(double cpuTime);
+    void updateBenchmark(double frameStart);
+    void postStatus(const String &text, bool isReport);
+    void postNotice(const String &text);
+    void showStatus(const String &report);
+    bool computeRowFromBus();
+    void computeRowFromSource(int numBins);
     Matrix3D<float> getProjectionMatrix() const;
     Matrix3D<float> getViewMatrix() const;
     void createShaders();
     struct Uniforms {
         Uniforms(OpenGLContext &context, OpenGLShaderProgram &shaders);
         ScopedPointer<OpenGLShaderProgram::Uniform> projectionMatrix, viewMatrix;
+        ScopedPointer<OpenGLShaderProgram::Uniform> layerMode, numLayers, rowLength, rowSpacing, gridWidth, heightScale;
+        ScopedPointer<OpenGLShaderProgram::Uniform> ringOffset, historyRows, shape, surface;
+        ScopedPointer<OpenGLShaderProgram::Uniform> heights, binCount, binSkew;
     private:
         static OpenGLShaderProgram::Uniform* createUniform(OpenGLContext &context, OpenGLShaderProgram &shaders, const char *uniformName);
     };
     GLfloat xWidth;
     GLfloat yHeight;
     GLfloat zDepth;
-    int xRes;
-    int zRes;
     
-    int numVertices;
-    GLfloat *xzVertices;
-    GLfloat *yVertices;
+    // The vertices of a level's grid have no attributes as everything is worked out from the vertex index
+    // The same indices draw every layer with a different base vertex
+    int numLayers;
+    
+    // Heights are kept as 16 bit fractions of yHeight, yHistory only holds the newest row of textureBins per layer
+    // Each level's height texture is a ring of its rows with a texture layer per layer, so only the newest row is uploaded each frame
+    // The shader filters between bins, so the grid can be any size whatever the number of bins
+    int textureBins;
+    float textureSkew;
+    SpectralHistory<GLushort> yHistory;
+    HeapBlock<GLfloat> newRow;
     
-    OpenGLContext gLContext;
-    GLuint xzVBO;
-    GLuint yVBO;
+    // Level 0 is the chosen resolution, each level after it has half the points across and half the history of the one before
+    Array<DetailLevel> detailLevels;
+    int builtResolution;
+    int activeLevel;
     GLuint VAO;
     
+    typedef void (APIENTRY *TexImage3DFunction) (GLenum, GLint, GLint, GLsizei, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid*);
+    typedef void (APIENTRY *TexSubImage3DFunction) (GLenum, GLint, GLint, GLint, GLint, GLsizei, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*);
+    TexImage3DFunction texImage3D;
+    TexSubImage3DFunction texSubImage3D;
+    
+    // Each level's shape indices are the points inside the shape in display order
+    typedef void (APIENTRY *DrawElementsBaseVertexFunction) (GLenum, GLsizei, GLenum, const GLvoid*, GLint);
+    DrawElementsBaseVertexFunction drawElementsBaseVertex;
+    
+    // Its surface indices are triangle strips between every two history rows, cut by the restart index wherever the shape's outline breaks a band
+    typedef void (APIENTRY *PrimitiveRestartIndexFunction) (GLuint);
+    PrimitiveRestartIndexFunction primitiveRestartIndex;
+    
     ScopedPointer<OpenGLShaderProgram> shader;
     ScopedPointer<Uniforms> uniforms;
     
@@ -68,10 +157,36 @@ private:
     
     // Audio Structures
     CircularBuffer * circBuffer;
-    AudioBuffer<GLfloat> readBuffer;
-    dsp::FFT forwardFFT;
+    SharedResourcePointer<SpectrumBus> spectrumBus;
+    int64 drawnVersion;
     GLfloat * fftData;
     std::string meshType;
+    MeshShape meshShape;
+    Atomic<SpectrumSource*> spectrumSource;
+    Atomic<int> layerMode;
+    Atomic<int> drawMode;
+    Atomic<int> resolution;
+    
+    // Frame timing, a benchmark steps the surface through a set of resolutions and reports the average times of each
+    Atomic<int> benchmarkRequested;
+    int benchmarkStep;
+    int benchmarkFrames;
+    int benchmarkSavedResolution;
+    int benchmarkSavedMode;
+    double benchmarkRenderTime;
+    double benchmarkFrameTime;
+    double lastFrameStart;
+    String benchmarkReport;
+    
+    // Adaptive detail, a frame costs whichever of its CPU and GPU time is longer and the level moves when the average
+    // stays over the budget, or well under it, for long enough. Decisions wait for the GPU timings of a new level to come back
+    GpuTimer gpuTimer;
+    Atomic<int> adaptiveDetail;
+    Atomic<float> frameBudget;
+    double averageCost;
+    int overBudgetFrames;
+    int underBudgetFrames;
+    int settleFrames;
 
     enum
     {
@@ -79,6 +194,12 @@ private:
         fftSize  = 1 << fftOrder // set 10th bit to one
     };
     
+    // The status label shows the shader's status, with the performance overlay under it while that is shown
+    FrameStats frameStats;
+    // Detail changes and benchmark results are kept as a notice between the two, the newest replacing the last
+    String shaderStatus;
+    String statusNotice;
+    bool overlayShown;
     Label statusLabel;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CircularMesh)
@@ -0,0 +1,42 @@
+/*
+  ==============================================================================
+
+    FFTPlanCache.cpp
+    Created: 19 Oct 2026 1:05:52pm
+    Author:  Esteban Cambronero
+    Process wide cache of dsp::FFT plans so every analysis path shares the same tables
+  ==============================================================================
+*/
+
+#include "FFTPlanCache.h"
+
+/*
+ Constructor for the plan cache, plans are only built when first requested
+ */
+FFTPlanCache::FFTPlanCache() {
+    for(int i = 0; i <= FFT_PLAN_MAX_ORDER; i++)
+        plans[i] = nullptr;
+}
+
+/*
+ Destructor for the plan cache
+ */
+FFTPlanCache::~FFTPlanCache() {
+    for(int i = 0; i <= FFT_PLAN_MAX_ORDER; i++)
+        delete plans[i];
+}
+
+/*
+ Returns the plan for an FFT of size 2^order, creating it the first time it is asked for
+ dsp::FFT is safe to perform from several threads at once so the same plan can be handed to everyone
+ */
+dsp::FFT &FFTPlanCache::getPlan(int order) {
+    jassert(order >= 0 && order <= FFT_PLAN_MAX_ORDER);
+    
+    const ScopedLock sl(planLock);
+    
+    if(plans[order] == nullptr)
+        plans[order] = new dsp::FFT(order);
+    
+    return *plans[order];
+}
@@ -0,0 +1,30 @@
+/*
+  ==============================================================================
+
+    FFTPlanCache.h
+    Created: 19 Oct 2026 1:05:52pm
+    Author:  Esteban Cambronero
+    Process wide cache of dsp::FFT plans so every analysis path shares the same tables
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#define FFT_PLAN_MAX_ORDER 16
+
+/*
+ Access through a SharedResourcePointer<FFTPlanCache>, plans live until the last pointer is released
+ */
+class FFTPlanCache
+{
+public:
+    FFTPlanCache();
+    ~FFTPlanCache();
+    dsp::FFT &getPlan(int order);
+private:
+    CriticalSection planLock;
+    dsp::FFT *plans[FFT_PLAN_MAX_ORDER + 1];
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FFTPlanCache)
+};
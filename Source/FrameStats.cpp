@@ -0,0 +1,166 @@
+/*
+  ==============================================================================
+
+    FrameStats.cpp
+    Created: 19 Oct 2026 7:03:25pm
+    Author:  Esteban Cambronero
+    Frame timings of a render pass, gathered for its performance overlay
+  ==============================================================================
+*/
+
+#include "FrameStats.h"
+
+// Upper edges of the frame time histogram's bins in milliseconds, the last bin has no upper edge
+static const double histogramEdges[FRAME_STATS_HISTOGRAM_BINS - 1] = { 8.0, 17.0, 25.0, 33.0, 50.0 };
+
+/*
+ Constructor for the frame stats, nothing is measured until they are enabled
+ */
+FrameStats::FrameStats() {
+    enabled = 0;
+    measuring = false;
+    lastFrameStart = 0.0;
+    stageStart = 0.0;
+    lastReport = 0.0;
+    lastGpuResult = 0;
+    droppedFrames = 0;
+    reset();
+}
+
+/*
+ Destructor for the frame stats, the analysis thread stops measuring once no overlay is shown
+ */
+FrameStats::~FrameStats() {
+    setEnabled(false);
+}
+
+/*
+ Starts or stops measuring, called from the message thread
+ */
+void FrameStats::setEnabled(bool shouldBeEnabled) {
+    const int newValue = shouldBeEnabled ? 1 : 0;
+    
+    if(enabled.exchange(newValue) == newValue)
+        return;
+    
+    if(shouldBeEnabled)
+        ++analysisLoad->numOverlays;
+    else
+        --analysisLoad->numOverlays;
+}
+
+/*
+ Called at the start of every frame on the render thread, returns whether this frame is being measured
+ */
+bool FrameStats::beginFrame(double targetInterval) {
+    const bool wasMeasuring = measuring;
+    measuring = enabled.get() != 0;
+    
+    if(! measuring)
+        return false;
+    
+    const double now = Time::getMillisecondCounterHiRes();
+    
+    if(! wasMeasuring) {
+        reset();
+        droppedFrames = 0;
+        lastReport = now;
+    }
+    else if(now - lastFrameStart < FRAME_STATS_PAUSE_GAP) {
+        const double interval = now - lastFrameStart;
+        int bin = 0;
+        
+        while(bin < FRAME_STATS_HISTOGRAM_BINS - 1 && interval >= histogramEdges[bin])
+            bin++;
+        
+        histogram[bin]++;
+        frameTimes += interval;
+        numFrames++;
+        
+        if(targetInterval > 0.0 && interval > 1.5 * targetInterval)
+            droppedFrames++;
+    }
+    
+    lastFrameStart = now;
+    numMeasured++;
+    return true;
+}
+
+/*
+ Marks the start of a stage of the frame
+ */
+void FrameStats::beginStage() noexcept {
+    if(measuring)
+        stageStart = Time::getMillisecondCounterHiRes();
+}
+
+/*
+ Adds the time since beginStage() to a stage, a stage can be timed more than once in a frame
+ */
+void FrameStats::endStage(Stage stage) noexcept {
+    if(measuring)
+        stageTimes[stage] += Time::getMillisecondCounterHiRes() - stageStart;
+}
+
+/*
+ Called at the end of every frame on the render thread after the pass's GPU timer has ended, returns whether a report is due
+ */
+bool FrameStats::endFrame(const GpuTimer &gpuTimer) {
+    if(! measuring)
+        return false;
+    
+    if(gpuTimer.getNumResults() != lastGpuResult) {
+        lastGpuResult = gpuTimer.getNumResults();
+        gpuTimes += gpuTimer.getLastMilliseconds();
+        numGpuTimes++;
+    }
+    
+    return Time::getMillisecondCounterHiRes() - lastReport >= FRAME_STATS_REPORT_INTERVAL;
+}
+
+/*
+ Sums up the frames since the last report as text and starts the next report
+ */
+String FrameStats::takeReport() {
+    const double frames = (double) jmax(1, numMeasured);
+    String report;
+    
+    report << "CPU  read " << String(stageTimes[RING_READ_STAGE] / frames, 2)
+           << "  upload " << String(stageTimes[UPLOAD_STAGE] / frames, 2)
+           << "  draw " << String(stageTimes[DRAW_STAGE] / frames, 2) << " ms\n";
+    
+    report << "GPU " << (numGpuTimes > 0 ? String(gpuTimes / numGpuTimes, 2) + " ms" : String("--"))
+           << "  frame " << (numFrames > 0 ? String(frameTimes / numFrames, 1) + " ms" : String("--"))
+           << "  dropped " << droppedFrames << "\n";
+    
+    for(int bin = 0; bin < FRAME_STATS_HISTOGRAM_BINS; bin++) {
+        if(bin < FRAME_STATS_HISTOGRAM_BINS - 1)
+            report << "<" << (int) histogramEdges[bin] << ": ";
+        else
+            report << (int) histogramEdges[bin - 1] << "+: ";
+        report << histogram[bin] << "  ";
+    }
+    
+    report << "\nAnalysis " << String(analysisLoad->blockTime.get(), 2) << " ms/block  ring "
+           << roundToInt(100.0f * analysisLoad->ringFill.get()) << "% full";
+    
+    reset();
+    lastReport = Time::getMillisecondCounterHiRes();
+    return report;
+}
+
+/*
+ Clears the sums since the last report
+ */
+void FrameStats::reset() {
+    for(int stage = 0; stage < NUM_STAGES; stage++)
+        stageTimes[stage] = 0.0;
+    for(int bin = 0; bin < FRAME_STATS_HISTOGRAM_BINS; bin++)
+        histogram[bin] = 0;
+    
+    numMeasured = 0;
+    frameTimes = 0.0;
+    numFrames = 0;
+    gpuTimes = 0.0;
+    numGpuTimes = 0;
+}
@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    FrameStats.h
+    Created: 19 Oct 2026 7:03:25pm
+    Author:  Esteban Cambronero
+    Frame timings of a render pass, gathered for its performance overlay
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AnalysisThread.h"
+#include "GpuTimer.h"
+
+#define FRAME_STATS_REPORT_INTERVAL 250.0
+#define FRAME_STATS_PAUSE_GAP 250.0
+#define FRAME_STATS_HISTOGRAM_BINS 6
+
+/*
+ Gathers a pass's CPU time per stage, GPU time and frame intervals on the render thread, and sums them up as text a few
+ times a second. While it is disabled a frame costs one check, and nothing is timed.
+ Frames that take more than one and a half times the host's frame interval count as dropped, gaps longer than
+ FRAME_STATS_PAUSE_GAP are taken as pauses in the drawing rather than dropped frames.
+ */
+class FrameStats
+{
+public:
+    enum Stage {
+        RING_READ_STAGE,
+        UPLOAD_STAGE,
+        DRAW_STAGE,
+        NUM_STAGES
+    };
+    FrameStats();
+    ~FrameStats();
+    void setEnabled(bool shouldBeEnabled);
+    bool beginFrame(double targetInterval);
+    void beginStage() noexcept;
+    void endStage(Stage stage) noexcept;
+    bool endFrame(const GpuTimer &gpuTimer);
+    String takeReport();
+private:
+    void reset();
+    
+    SharedResourcePointer<AnalysisLoad> analysisLoad;
+    Atomic<int> enabled;
+    bool measuring;
+    double lastFrameStart;
+    double stageStart;
+    double lastReport;
+    
+    // Sums since the last report
+    double stageTimes[NUM_STAGES];
+    int numMeasured;
+    double frameTimes;
+    int numFrames;
+    double gpuTimes;
+    int numGpuTimes;
+    int64 lastGpuResult;
+    int histogram[FRAME_STATS_HISTOGRAM_BINS];
+    
+    // Counted from when the overlay was shown
+    int64 droppedFrames;
+    
+    JUCE_DECLARE_NON_COPYABLE(FrameStats)
+};
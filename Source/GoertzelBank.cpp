@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+    GoertzelBank.cpp
+    Created: 19 Oct 2026 3:12:26pm
+    Author:  Esteban Cambronero
+    Analysis stage that tracks a sparse set of fixed frequencies with streaming resonators
+  ==============================================================================
+*/
+
+#include "GoertzelBank.h"
+
+/*
+ Constructor for the resonator bank, monitors mains hum harmonics, common test tones and the FM stereo pilot by default
+ */
+GoertzelBank::GoertzelBank() {
+    sampleRate = 44100.0;
+    numChannels = 0;
+    numResonators = 0;
+    numGroups = 0;
+    publishedResonators = 0;
+    
+    Array<float> defaults;
+    for(int harmonic = 1; harmonic <= 12; harmonic++)
+        defaults.add(50.0f * harmonic);
+    for(int harmonic = 1; harmonic <= 10; harmonic++)
+        defaults.addIfNotAlreadyThere(60.0f * harmonic);
+    defaults.add(440.0f);
+    defaults.add(997.0f);
+    defaults.add(1000.0f);
+    defaults.add(19000.0f);
+    defaults.sort();
+    
+    setFrequencies(defaults, GOERTZEL_DEFAULT_BANDWIDTH);
+}
+
+/*
+ Sets the frequencies to monitor (at most GOERTZEL_MAX_RESONATORS, lowest first) and the -3 dB bandwidth of each resonator in Hz
+ Narrower bandwidths separate closer tones but take longer (about 1 / bandwidth seconds) to settle
+ */
+void GoertzelBank::setFrequencies(const Array<float> &newFrequencies, float newBandwidth) {
+    const ScopedLock sl(settingsLock);
+    
+    frequencies = newFrequencies;
+    frequencies.removeRange(GOERTZEL_MAX_RESONATORS, frequencies.size());
+    bandwidth = jmax(0.1f, newBandwidth);
+    settingsChanged = 1;
+}
+
+/*
+ Allocates the mono mix buffer and rebuilds the resonators for the sample rate
+ */
+void GoertzelBank::prepare(double rate, int channels, int maxBlockSize) {
+    sampleRate = rate;
+    numChannels = channels;
+    mono.allocate(maxBlockSize, true);
+    updateCoefficients();
+}
+
+/*
+ Runs every resonator over the block and publishes their magnitudes
+ Each resonator is a damped complex rotation y[n] = r e^(jw) y[n-1] + (1 - r) x[n], a streaming
+ Goertzel whose magnitude settles on the amplitude of the matching component
+ */
+void GoertzelBank::process(const AudioBuffer<float> &block, int numSamples) {
+    if(settingsChanged.compareAndSetBool(0, 1))
+        updateCoefficients();
+    
+    const float gain = 1.0f / jmax(1, numChannels);
+    FloatVectorOperations::copyWithMultiply(mono, block.getReadPointer(0), gain, numSamples);
+    for(int channel = 1; channel < numChannels; channel++)
+        FloatVectorOperations::addWithMultiply(mono, block.getReadPointer(channel), gain, numSamples);
+    
+    for(int group = 0; group < numGroups; group++) {
+        const Vec c = cosine[group];
+        const Vec s = sine[group];
+        const Vec g = inputGain[group];
+        Vec re = real[group];
+        Vec im = imaginary[group];
+        
+        for(int i = 0; i < numSamples; i++) {
+            const Vec x = Vec::expand(mono[i]);
+            const Vec newRe = c * re - s * im + g * x;
+            im = s * re + c * im;
+            re = newRe;
+        }
+        
+        real[group] = re;
+        imaginary[group] = im;
+    }
+    
+    Result &result = results.getWriteBuffer();
+    const float *re = real.getRawData();
+    const float *im = imaginary.getRawData();
+    
+    // A real sinusoid puts half its amplitude on the positive frequency the resonator follows
+    for(int i = 0; i < numResonators; i++)
+        result.magnitudes[i] = 2.0f * std::sqrt(re[i] * re[i] + im[i] * im[i]);
+    result.numResonators = numResonators;
+    results.publish();
+    publishedResonators = numResonators;
+}
+
+/*
+ One bin per monitored frequency
+ */
+int GoertzelBank::getNumBins() const {
+    return publishedResonators.get();
+}
+
+/*
+ Copies the newest resonator magnitudes, lowest frequency first, nothing is copied until the first result is published
+ */
+int GoertzelBank::readSpectrum(float *dest, int maxBins) {
+    results.fetch();
+    
+    if(! results.hasData())
+        return 0;
+    
+    const Result &result = results.getReadBuffer();
+    const int numBins = jlimit(0, jmin(maxBins, GOERTZEL_MAX_RESONATORS), result.numResonators);
+    FloatVectorOperations::copy(dest, result.magnitudes, numBins);
+    return numBins;
+}
+
+/*
+ Rebuilds the resonator coefficients and clears their state, runs on the analysis thread
+ */
+void GoertzelBank::updateCoefficients() {
+    const ScopedLock sl(settingsLock);
+    const int width = (int) Vec::size();
+    
+    numResonators = frequencies.size();
+    numGroups = (numResonators + width - 1) / width;
+    
+    cosine.allocate(numGroups);
+    sine.allocate(numGroups);
+    inputGain.allocate(numGroups);
+    real.allocate(numGroups);
+    imaginary.allocate(numGroups);
+    
+    // Pole radius for the requested -3 dB bandwidth
+    const double radius = std::exp(-MathConstants<double>::pi * bandwidth / sampleRate);
+    
+    for(int i = 0; i < numResonators; i++) {
+        const double omega = MathConstants<double>::twoPi * jmin((double) frequencies[i], 0.5 * sampleRate) / sampleRate;
+        
+        cosine.getRawData()[i] = (float) (radius * std::cos(omega));
+        sine.getRawData()[i] = (float) (radius * std::sin(omega));
+        inputGain.getRawData()[i] = (float) (1.0 - radius);
+    }
+}
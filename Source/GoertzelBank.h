@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    GoertzelBank.h
+    Created: 19 Oct 2026 3:12:26pm
+    Author:  Esteban Cambronero
+    Analysis stage that tracks a sparse set of fixed frequencies with streaming resonators
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AnalysisStage.h"
+#include "SpectrumSource.h"
+#include "SIMDArray.h"
+#include "TripleBuffer.h"
+
+#define GOERTZEL_MAX_RESONATORS 64
+#define GOERTZEL_DEFAULT_BANDWIDTH 5.0f
+
+class GoertzelBank : public AnalysisStage, public SpectrumSource
+{
+public:
+    GoertzelBank();
+    void setFrequencies(const Array<float> &frequencies, float bandwidth);
+    void prepare(double sampleRate, int numChannels, int maxBlockSize) override;
+    void process(const AudioBuffer<float> &block, int numSamples) override;
+    int getNumBins() const override;
+    int readSpectrum(float *dest, int maxBins) override;
+private:
+    typedef dsp::SIMDRegister<float> Vec;
+    struct Result {
+        float magnitudes[GOERTZEL_MAX_RESONATORS];
+        int numResonators;
+    };
+    void updateCoefficients();
+    
+    double sampleRate;
+    int numChannels;
+    HeapBlock<float> mono;
+    
+    // Resonators are grouped into SIMD registers, so one pass over the samples runs several at once
+    int numResonators;
+    int numGroups;
+    SIMDArray<float> cosine;
+    SIMDArray<float> sine;
+    SIMDArray<float> inputGain;
+    SIMDArray<float> real;
+    SIMDArray<float> imaginary;
+    
+    CriticalSection settingsLock;
+    Array<float> frequencies;
+    float bandwidth;
+    Atomic<int> settingsChanged;
+    
+    TripleBuffer<Result> results;
+    Atomic<int> publishedResonators;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GoertzelBank)
+};
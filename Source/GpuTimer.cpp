@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    GpuTimer.cpp
+    Created: 19 Oct 2026 6:12:40pm
+    Author:  Esteban Cambronero
+    Measures how long the GPU spends on a span of GL commands without waiting for it
+  ==============================================================================
+*/
+
+#include "GpuTimer.h"
+
+#ifndef GL_TIME_ELAPSED
+ #define GL_TIME_ELAPSED 0x88BF
+#endif
+#ifndef GL_QUERY_RESULT
+ #define GL_QUERY_RESULT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+ #define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+
+/*
+ Constructor for the timer, nothing is timed until it is created in a context
+ */
+GpuTimer::GpuTimer() {
+    genQueries = nullptr;
+    deleteQueries = nullptr;
+    beginQuery = nullptr;
+    endQuery = nullptr;
+    getQueryObjectiv = nullptr;
+    getQueryObjectui64v = nullptr;
+    oldestQuery = 0;
+    numPending = 0;
+    timing = false;
+    lastMilliseconds = 0.0;
+    numResults = 0;
+}
+
+/*
+ Creates the queries in the active context, without timer queries (core since OpenGL 3.3) nothing is timed
+ */
+void GpuTimer::create() {
+    genQueries = (GenQueriesFunction) OpenGLHelpers::getExtensionFunction ("glGenQueries");
+    deleteQueries = (DeleteQueriesFunction) OpenGLHelpers::getExtensionFunction ("glDeleteQueries");
+    beginQuery = (BeginQueryFunction) OpenGLHelpers::getExtensionFunction ("glBeginQuery");
+    endQuery = (EndQueryFunction) OpenGLHelpers::getExtensionFunction ("glEndQuery");
+    getQueryObjectiv = (GetQueryObjectivFunction) OpenGLHelpers::getExtensionFunction ("glGetQueryObjectiv");
+    getQueryObjectui64v = (GetQueryObjectui64vFunction) OpenGLHelpers::getExtensionFunction ("glGetQueryObjectui64v");
+    
+    if (! isAvailable())
+        return;
+    
+    genQueries (GPU_TIMER_QUERIES, queries);
+    oldestQuery = 0;
+    numPending = 0;
+    timing = false;
+}
+
+/*
+ Deletes the queries, any results still in flight are dropped
+ */
+void GpuTimer::release() {
+    if (timing)
+        end();
+    
+    if (isAvailable())
+        deleteQueries (GPU_TIMER_QUERIES, queries);
+    
+    beginQuery = nullptr;
+    numPending = 0;
+}
+
+/*
+ Starts timing the GL commands that follow, only one timer can be running in a context at a time
+ */
+void GpuTimer::begin() {
+    if (! isAvailable() || timing)
+        return;
+    
+    collectResults();
+    
+    if (numPending == GPU_TIMER_QUERIES)
+        return;
+    
+    beginQuery (GL_TIME_ELAPSED, queries[(oldestQuery + numPending) % GPU_TIMER_QUERIES]);
+    timing = true;
+}
+
+/*
+ Stops timing, the result is picked up by a later begin() once the GPU has finished the commands
+ */
+void GpuTimer::end() {
+    if (! timing)
+        return;
+    
+    endQuery (GL_TIME_ELAPSED);
+    timing = false;
+    ++numPending;
+}
+
+/*
+ Whether the context has timer queries
+ */
+bool GpuTimer::isAvailable() const noexcept {
+    return genQueries != nullptr && deleteQueries != nullptr && beginQuery != nullptr && endQuery != nullptr
+        && getQueryObjectiv != nullptr && getQueryObjectui64v != nullptr;
+}
+
+/*
+ GPU time of the newest span that has finished, in milliseconds
+ */
+double GpuTimer::getLastMilliseconds() const noexcept {
+    return lastMilliseconds;
+}
+
+/*
+ Number of spans timed so far, it only moves on when a new result has been read
+ */
+int64 GpuTimer::getNumResults() const noexcept {
+    return numResults;
+}
+
+/*
+ Reads every query that the GPU has finished with, oldest first, stopping at the first that is not ready
+ */
+void GpuTimer::collectResults() {
+    while (numPending > 0)
+    {
+        GLint available = 0;
+        getQueryObjectiv (queries[oldestQuery], GL_QUERY_RESULT_AVAILABLE, &available);
+        
+        if (available == 0)
+            break;
+        
+        uint64 nanoseconds = 0;
+        getQueryObjectui64v (queries[oldestQuery], GL_QUERY_RESULT, &nanoseconds);
+        lastMilliseconds = (double) nanoseconds * 1.0e-6;
+        ++numResults;
+        
+        oldestQuery = (oldestQuery + 1) % GPU_TIMER_QUERIES;
+        --numPending;
+    }
+}
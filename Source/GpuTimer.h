@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    GpuTimer.h
+    Created: 19 Oct 2026 6:12:40pm
+    Author:  Esteban Cambronero
+    Measures how long the GPU spends on a span of GL commands without waiting for it
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "RenderHost.h"
+
+#define GPU_TIMER_QUERIES 3
+
+/*
+ Times a span of GL commands with GL_TIME_ELAPSED queries, the results are read a few frames later once they are ready
+ so the render thread never stalls on the GPU. A span is left untimed if every query is still in flight.
+ Must only be used on the render thread, between create() and release().
+ */
+class GpuTimer
+{
+public:
+    GpuTimer();
+    void create();
+    void release();
+    void begin();
+    void end();
+    bool isAvailable() const noexcept;
+    double getLastMilliseconds() const noexcept;
+    int64 getNumResults() const noexcept;
+private:
+    void collectResults();
+    
+    typedef void (APIENTRY *GenQueriesFunction) (GLsizei, GLuint*);
+    typedef void (APIENTRY *DeleteQueriesFunction) (GLsizei, const GLuint*);
+    typedef void (APIENTRY *BeginQueryFunction) (GLenum, GLuint);
+    typedef void (APIENTRY *EndQueryFunction) (GLenum);
+    typedef void (APIENTRY *GetQueryObjectivFunction) (GLuint, GLenum, GLint*);
+    typedef void (APIENTRY *GetQueryObjectui64vFunction) (GLuint, GLenum, uint64*);
+    GenQueriesFunction genQueries;
+    DeleteQueriesFunction deleteQueries;
+    BeginQueryFunction beginQuery;
+    EndQueryFunction endQuery;
+    GetQueryObjectivFunction getQueryObjectiv;
+    GetQueryObjectui64vFunction getQueryObjectui64v;
+    
+    // Queries are issued round the ring and read back oldest first
+    GLuint queries[GPU_TIMER_QUERIES];
+    int oldestQuery;
+    int numPending;
+    bool timing;
+    double lastMilliseconds;
+    int64 numResults;
+    
+    JUCE_DECLARE_NON_COPYABLE(GpuTimer)
+};
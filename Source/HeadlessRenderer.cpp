@@ -0,0 +1,246 @@
+/*
+  ==============================================================================
+
+    HeadlessRenderer.cpp
+    Created: 19 Oct 2026 8:21:54pm
+    Author:  Esteban Cambronero
+    Renders a visualizer of an audio file to a sequence of images, without the GUI
+  ==============================================================================
+*/
+
+#include "HeadlessRenderer.h"
+
+/*
+ Constructor for the headless renderer, nothing happens until it is started
+ */
+HeadlessRenderer::HeadlessRenderer() : Thread("Headless Renderer"), writers(SystemStats::getNumCpus()) {
+    frameRate = HEADLESS_DEFAULT_FRAME_RATE;
+    rawFrames = false;
+    failedWrites = 0;
+    formatManager.registerBasicFormats();
+}
+
+/*
+ Destructor for the headless renderer, stops rendering and waits for the frames already drawn to be written
+ */
+HeadlessRenderer::~HeadlessRenderer() {
+    stopThread(10000);
+    writers.removeAllJobs(false, 10000);
+    
+    visualizer = nullptr;
+    analysis = nullptr;
+    circBuffer = nullptr;
+}
+
+/*
+ Whether the app was started to render headless rather than with its window
+ */
+bool HeadlessRenderer::isRequested(const ArgumentList &arguments) {
+    return arguments.containsOption("--render");
+}
+
+/*
+ Opens the audio file, sets up the visualizer in a borderless window and starts rendering, called on the message thread
+ Returns why it could not start, or an empty string if it did
+ */
+String HeadlessRenderer::start(const ArgumentList &arguments) {
+    const File audioFile = File::getCurrentWorkingDirectory().getChildFile(arguments.getValueForOption("--render"));
+    reader = formatManager.createReaderFor(audioFile);
+    
+    if(reader == nullptr)
+        return "Could not read audio from " + audioFile.getFullPathName();
+    
+    outputFolder = File::getCurrentWorkingDirectory().getChildFile(arguments.getValueForOption("--output"));
+    
+    if(! outputFolder.createDirectory())
+        return "Could not create " + outputFolder.getFullPathName();
+    
+    const String fps = arguments.getValueForOption("--fps");
+    frameRate = fps.isNotEmpty() ? jlimit(1, 1000, fps.getIntValue()) : HEADLESS_DEFAULT_FRAME_RATE;
+    rawFrames = arguments.containsOption("--raw");
+    
+    int width = HEADLESS_DEFAULT_WIDTH;
+    int height = HEADLESS_DEFAULT_HEIGHT;
+    const String size = arguments.getValueForOption("--size");
+    
+    if(size.containsChar('x')) {
+        width = jlimit(16, 8192, size.upToFirstOccurrenceOf("x", false, true).getIntValue());
+        height = jlimit(16, 8192, size.fromFirstOccurrenceOf("x", false, true).getIntValue());
+    }
+    
+   #if JUCE_LINUX
+    // Mesa reads these when the context is created, llvmpipe otherwise stops at a fixed number of threads
+    if(arguments.containsOption("--software")) {
+        setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
+        setenv("LP_NUM_THREADS", String(SystemStats::getNumCpus()).toRawUTF8(), 0);
+    }
+   #endif
+    
+    // Enough room for a few frames of audio, so the waveform never falls behind the writes
+    const double samplesPerFrame = reader->sampleRate / frameRate;
+    circBuffer = new CircularBuffer(2, jmax(4 * ANALYSIS_BLOCK_SIZE, 4 * (int) std::ceil(samplesPerFrame)));
+    analysis = new AnalysisThread(circBuffer, reader->sampleRate);
+    analysis->addStage(spectrumBus);
+    
+    // Frames are only drawn when they are asked for, straight into the offscreen buffer
+    renderHost.setDrawingOnScreen(false);
+    renderHost.setSwapInterval(0);
+    renderHost.setSize(width, height);
+    renderHost.addToDesktop(0);
+    renderHost.setVisible(true);
+    
+    const String type = arguments.getValueForOption("--visualizer");
+    
+    if(type == "waveform") {
+        SineVisualizer *sine = new SineVisualizer(renderHost, circBuffer);
+        sine->setWindowLength((int) std::ceil(samplesPerFrame));
+        visualizer = sine;
+    }
+    else {
+        CircularMesh *mesh = new CircularMesh(renderHost, circBuffer, type.isNotEmpty() ? type.toStdString() : std::string("circle"));
+        mesh->setDrawMode(arguments.containsOption("--surface") ? CircularMesh::SURFACE_MODE : CircularMesh::POINTS_MODE);
+        
+        const String resolution = arguments.getValueForOption("--resolution");
+        mesh->setResolution(resolution.isNotEmpty() ? resolution.getIntValue() : MESH_DEFAULT_RESOLUTION);
+        
+        // Every frame is drawn at the chosen detail, however long it takes
+        mesh->setAdaptiveDetail(false);
+        visualizer = mesh;
+    }
+    
+    visualizer->setBounds(renderHost.getLocalBounds());
+    visualizer->setVisible(true);
+    
+    startThread();
+    return {};
+}
+
+/*
+ Steps through the audio a frame at a time, analysing it and drawing the visualizer after every step
+ */
+void HeadlessRenderer::run() {
+    const double sampleRate = reader->sampleRate;
+    const int numFrames = (int) (reader->lengthInSamples * frameRate / sampleRate);
+    AudioBuffer<float> audio(2, (int) std::ceil(sampleRate / frameRate) + 1);
+    Image frame;
+    int64 position = 0;
+    int framesDrawn = 0;
+    bool failed = false;
+    
+    // The context is created on the render thread once the window is up
+    for(int waited = 0; ! renderHost.isContextReady() && waited < 10000 && ! threadShouldExit(); waited += 10)
+        wait(10);
+    
+    const double startTime = Time::getMillisecondCounterHiRes();
+    
+    while(framesDrawn < numFrames && ! threadShouldExit()) {
+        // Frames end on whole samples, so the steps even out to exactly the frame rate
+        const int64 frameEnd = (int64) ((framesDrawn + 1) * sampleRate / frameRate);
+        const int numSamples = (int) (frameEnd - position);
+        
+        reader->read(&audio, 0, numSamples, position, true, true);
+        circBuffer->write(audio, 0, numSamples);
+        position = frameEnd;
+        
+        while(analysis->processNextBlock()) {}
+        
+        if(! renderHost.renderOffscreen(frame)) {
+            Logger::writeToLog("Could not draw frame " + String(framesDrawn) + ", no OpenGL context or frame buffer");
+            failed = true;
+            break;
+        }
+        
+        writeFrame(frame, framesDrawn++);
+    }
+    
+    while(writers.getNumJobs() > 0 && ! threadShouldExit())
+        wait(1);
+    
+    if(failedWrites.get() > 0) {
+        Logger::writeToLog(String(failedWrites.get()) + " frames could not be written to " + outputFolder.getFullPathName());
+        failed = true;
+    }
+    
+    const double seconds = (Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+    Logger::writeToLog("Rendered " + String(framesDrawn) + " frames in " + String(seconds, 2) + " s, "
+                       + String(framesDrawn / jmax(seconds, 0.001), 1) + " frames per second, to "
+                       + outputFolder.getFullPathName());
+    
+    MessageManager::callAsync([failed] {
+        JUCEApplicationBase::getInstance()->setApplicationReturnValue(failed ? 1 : 0);
+        JUCEApplicationBase::quit();
+    });
+}
+
+/*
+ Hands a copy of the frame to the writers, waiting while they are too far behind so frames don't pile up in memory
+ */
+void HeadlessRenderer::writeFrame(const Image &frame, int frameIndex) {
+    while(writers.getNumJobs() >= HEADLESS_WRITES_PER_THREAD * writers.getNumThreads() && ! threadShouldExit())
+        wait(1);
+    
+    const String name = String::formatted("frame_%06d", frameIndex) + (rawFrames ? ".rgba" : ".png");
+    writers.addJob(new FrameWriter(frame.createCopy(), outputFolder.getChildFile(name), rawFrames, failedWrites), true);
+}
+
+/*
+ Constructor for a frame writer, it owns its copy of the frame
+ */
+HeadlessRenderer::FrameWriter::FrameWriter(const Image &frame, const File &file, bool raw, Atomic<int> &failures)
+    : ThreadPoolJob("Frame Writer"), failedWrites(failures) {
+    image = frame;
+    destination = file;
+    writeRaw = raw;
+}
+
+/*
+ Writes the frame, counting it as failed if any part of it could not be written
+ */
+ThreadPoolJob::JobStatus HeadlessRenderer::FrameWriter::runJob() {
+    if(! write()) {
+        Logger::writeToLog("Could not write " + destination.getFullPathName());
+        ++failedWrites;
+    }
+    
+    return jobHasFinished;
+}
+
+/*
+ Writes the frame as a PNG, or as rows of RGBA bytes from the top, returns false if the file could not be opened or written
+ */
+bool HeadlessRenderer::FrameWriter::write() {
+    destination.deleteFile();
+    FileOutputStream stream(destination);
+    
+    if(stream.failedToOpen())
+        return false;
+    
+    if(! writeRaw) {
+        PNGImageFormat png;
+        
+        if(! png.writeImageToStream(image, stream))
+            return false;
+        
+        stream.flush();
+        return stream.getStatus().wasOk();
+    }
+    
+    const Image::BitmapData data(image, Image::BitmapData::readOnly);
+    HeapBlock<uint8> row((size_t) image.getWidth() * 4);
+    
+    for(int y = 0; y < image.getHeight(); y++) {
+        for(int x = 0; x < image.getWidth(); x++) {
+            PixelARGB pixel = *(const PixelARGB*) data.getPixelPointer(x, y);
+            pixel.unpremultiply();
+            row[4 * x] = pixel.getRed();
+            row[4 * x + 1] = pixel.getGreen();
+            row[4 * x + 2] = pixel.getBlue();
+            row[4 * x + 3] = pixel.getAlpha();
+        }
+        if(! stream.write(row, (size_t) image.getWidth() * 4))
+            return false;
+    }
+    
+    stream.flush();
+    return stream.getStatus().wasOk();
+}
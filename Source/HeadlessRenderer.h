@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    HeadlessRenderer.h
+    Created: 19 Oct 2026 8:21:54pm
+    Author:  Esteban Cambronero
+    Renders a visualizer of an audio file to a sequence of images, without the GUI
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "CircularBuffer.h"
+#include "AnalysisThread.h"
+#include "SpectrumBus.h"
+#include "RenderHost.h"
+#include "CircularMesh.h"
+#include "SineVisualizer.h"
+
+#define HEADLESS_DEFAULT_FRAME_RATE 30
+#define HEADLESS_DEFAULT_WIDTH 1280
+#define HEADLESS_DEFAULT_HEIGHT 720
+#define HEADLESS_WRITES_PER_THREAD 2
+
+/*
+ Feeds an audio file through the analysis and one visualizer as fast as they go, one fixed step of audio per frame, and
+ writes every frame as a PNG or raw RGBA image. The frames per second it managed are logged at the end and the app quits.
+ JUCE's contexts need a window, so the host is put in a borderless one and every frame is drawn into an offscreen
+ frame buffer instead, on a machine with no display that window can live on a virtual X server such as Xvfb.
+ With --software the context uses Mesa's llvmpipe with a rasterizer thread per core.
+ The command line is
+ --render=<audio file> --output=<folder> [--visualizer=circle|square|triangle|line|waveform] [--fps=30]
+ [--size=1280x720] [--surface] [--resolution=80] [--raw] [--software]
+ */
+class HeadlessRenderer : private Thread
+{
+public:
+    HeadlessRenderer();
+    ~HeadlessRenderer();
+    static bool isRequested(const ArgumentList &arguments);
+    String start(const ArgumentList &arguments);
+private:
+    void run() override;
+    void writeFrame(const Image &frame, int frameIndex);
+    
+    // Each frame is written on the pool, so images are encoded on every core while the next frame is drawn
+    // Frames that could not be written are counted, so the app can quit with an error
+    class FrameWriter : public ThreadPoolJob {
+    public:
+        FrameWriter(const Image &frame, const File &file, bool raw, Atomic<int> &failures);
+        JobStatus runJob() override;
+    private:
+        bool write();
+        Image image;
+        File destination;
+        bool writeRaw;
+        Atomic<int> &failedWrites;
+    };
+    
+    File outputFolder;
+    int frameRate;
+    bool rawFrames;
+    Atomic<int> failedWrites;
+    
+    AudioFormatManager formatManager;
+    ScopedPointer<AudioFormatReader> reader;
+    ScopedPointer<CircularBuffer> circBuffer;
+    ScopedPointer<AnalysisThread> analysis;
+    SharedResourcePointer<SpectrumBus> spectrumBus;
+    
+    // The visualizer has to go before the host it is drawn by
+    RenderHost renderHost;
+    ScopedPointer<RenderPass> visualizer;
+    ThreadPool writers;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HeadlessRenderer)
+};
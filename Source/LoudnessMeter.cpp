@@ -0,0 +1,362 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.cpp
+    Created: 19 Oct 2026 10:48:19am
+    Author:  Esteban Cambronero
+    EBU R128 / ITU-R BS.1770 loudness meter run as an analysis stage
+  ==============================================================================
+*/
+
+#include "LoudnessMeter.h"
+
+// 4x oversampling interpolation filter from ITU-R BS.1770-4 Annex 2, one row per phase
+static const float truePeakFilter[TRUE_PEAK_PHASES][TRUE_PEAK_TAPS] = {
+    {  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f, -0.0594482421875f,  0.1373291015625f,
+       0.9721679687500f, -0.1022949218750f,  0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f },
+    { -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f, -0.1665039062500f,  0.4650878906250f,
+       0.7797851562500f, -0.2003173828125f,  0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+    { -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,  0.1015625000000f, -0.2003173828125f,  0.7797851562500f,
+       0.4650878906250f, -0.1665039062500f,  0.0891113281250f, -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+    { -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,  0.0476074218750f, -0.1022949218750f,  0.9721679687500f,
+       0.1373291015625f, -0.0594482421875f,  0.0332031250000f, -0.0196533203125f,  0.0109863281250f,  0.0017089843750f }
+};
+
+/*
+ Constructor for the loudness meter, every channel starts with unity weight
+ */
+LoudnessMeter::LoudnessMeter() {
+    numChannels = 0;
+    numGroups = 0;
+    subBlockLength = 1;
+    samplesInSubBlock = 0;
+    historyPosition = 0;
+    
+    for(int i = 0; i < LOUDNESS_MAX_CHANNELS; i++)
+        channelWeights[i] = 1.0f;
+    
+    clearState();
+    resetRequested = 0;
+}
+
+/*
+ Allocates the interleaved working buffers and computes the K-weighting filters for the sample rate
+ */
+void LoudnessMeter::prepare(double sampleRate, int channels, int maxBlockSize) {
+    const int width = (int) Vec::size();
+    
+    numChannels = jmin(channels, LOUDNESS_MAX_CHANNELS);
+    numGroups = (numChannels + width - 1) / width;
+    subBlockLength = jmax(1, roundToInt(sampleRate * 0.1));
+    
+    interleaved.allocate(maxBlockSize * numGroups);
+    filterState.allocate(numGroups * 4);
+    energy.allocate(numGroups);
+    peaks.allocate(numGroups);
+    peakHistory.allocate(numGroups * 2 * TRUE_PEAK_TAPS);
+    
+    weights.allocate(numGroups);
+    for(int i = 0; i < numChannels; i++)
+        weights.getRawData()[i] = channelWeights[i];
+    
+    // Stored reversed so the oldest sample in the history lines up with the first coefficient
+    truePeakCoefficients.allocate(TRUE_PEAK_PHASES * TRUE_PEAK_TAPS);
+    for(int phase = 0; phase < TRUE_PEAK_PHASES; phase++)
+        for(int tap = 0; tap < TRUE_PEAK_TAPS; tap++)
+            truePeakCoefficients[phase * TRUE_PEAK_TAPS + tap] = Vec::expand(truePeakFilter[phase][TRUE_PEAK_TAPS - 1 - tap]);
+    
+    setupKWeighting(sampleRate);
+    clearState();
+}
+
+/*
+ Feeds a new block through the K-weighting filters and true peak interpolator
+ */
+void LoudnessMeter::process(const AudioBuffer<float> &block, int numSamples) {
+    if(resetRequested.compareAndSetBool(0, 1))
+        clearState();
+    
+    int position = 0;
+    
+    while(position < numSamples) {
+        int chunk = jmin(numSamples - position, subBlockLength - samplesInSubBlock);
+        
+        interleave(block, position, chunk);
+        processChunk(chunk);
+        
+        position += chunk;
+        samplesInSubBlock += chunk;
+        
+        if(samplesInSubBlock == subBlockLength)
+            endSubBlock();
+    }
+}
+
+/*
+ Restarts the integration, safe to call from any thread as the analysis thread does the actual clearing
+ */
+void LoudnessMeter::reset() {
+    resetRequested = 1;
+}
+
+/*
+ Sets the BS.1770 channel weight (1.0 for front channels, 1.41 for surrounds, 0.0 to exclude the LFE)
+ Takes effect the next time the meter is prepared
+ */
+void LoudnessMeter::setChannelWeight(int channel, float weight) {
+    if(channel >= 0 && channel < LOUDNESS_MAX_CHANNELS)
+        channelWeights[channel] = weight;
+}
+
+/*
+ Loudness over the last 400 ms in LUFS
+ */
+float LoudnessMeter::getMomentaryLoudness() const {
+    return momentary.get();
+}
+
+/*
+ Loudness over the last 3 s in LUFS
+ */
+float LoudnessMeter::getShortTermLoudness() const {
+    return shortTerm.get();
+}
+
+/*
+ Gated loudness since the last reset in LUFS
+ */
+float LoudnessMeter::getIntegratedLoudness() const {
+    return integrated.get();
+}
+
+/*
+ Highest 4x oversampled peak since the last reset in dBTP
+ */
+float LoudnessMeter::getTruePeak() const {
+    return truePeak.get();
+}
+
+/*
+ Computes the two K-weighting biquads (high shelf pre-filter then RLB high pass) for any sample rate
+ Both are derived from the analog prototypes so they match the BS.1770 coefficients at 48 kHz
+ */
+void LoudnessMeter::setupKWeighting(double sampleRate) {
+    double K, Q, a0;
+    
+    // Stage 1: high shelf modelling the acoustic effect of the head
+    const double shelfGain = 3.999843853973347;
+    K = std::tan(MathConstants<double>::pi * 1681.974450955533 / sampleRate);
+    Q = 0.7071752369554196;
+    const double Vh = std::pow(10.0, shelfGain / 20.0);
+    const double Vb = std::pow(Vh, 0.4996667741545416);
+    a0 = 1.0 + K / Q + K * K;
+    shelf.b0 = Vec::expand((float) ((Vh + Vb * K / Q + K * K) / a0));
+    shelf.b1 = Vec::expand((float) (2.0 * (K * K - Vh) / a0));
+    shelf.b2 = Vec::expand((float) ((Vh - Vb * K / Q + K * K) / a0));
+    shelf.a1 = Vec::expand((float) (2.0 * (K * K - 1.0) / a0));
+    shelf.a2 = Vec::expand((float) ((1.0 - K / Q + K * K) / a0));
+    
+    // Stage 2: revised low frequency B-curve high pass
+    K = std::tan(MathConstants<double>::pi * 38.13547087602444 / sampleRate);
+    Q = 0.5003270373238773;
+    a0 = 1.0 + K / Q + K * K;
+    highPass.b0 = Vec::expand(1.0f);
+    highPass.b1 = Vec::expand(-2.0f);
+    highPass.b2 = Vec::expand(1.0f);
+    highPass.a1 = Vec::expand((float) (2.0 * (K * K - 1.0) / a0));
+    highPass.a2 = Vec::expand((float) ((1.0 - K / Q + K * K) / a0));
+}
+
+/*
+ Copies numSamples from every channel into the interleaved buffer, one SIMD register per channel group per sample
+ */
+void LoudnessMeter::interleave(const AudioBuffer<float> &block, int start, int numSamples) {
+    const int width = (int) Vec::size();
+    const int stride = numGroups * width;
+    float *dest = interleaved.getRawData();
+    
+    for(int channel = 0; channel < jmin(numChannels, block.getNumChannels()); channel++) {
+        const float *source = block.getReadPointer(channel, start);
+        float *lane = dest + (channel / width) * width + (channel % width);
+        
+        for(int i = 0; i < numSamples; i++)
+            lane[i * stride] = source[i];
+    }
+}
+
+/*
+ Runs the interleaved samples through the K-weighting cascade, accumulating the energy,
+ and through the polyphase interpolator to track the true peak
+ */
+void LoudnessMeter::processChunk(int numSamples) {
+    int position = historyPosition;
+    
+    for(int group = 0; group < numGroups; group++) {
+        Vec s1 = filterState[group * 4];
+        Vec s2 = filterState[group * 4 + 1];
+        Vec s3 = filterState[group * 4 + 2];
+        Vec s4 = filterState[group * 4 + 3];
+        Vec sum = energy[group];
+        Vec peak = peaks[group];
+        Vec *history = peakHistory.getData() + group * 2 * TRUE_PEAK_TAPS;
+        
+        position = historyPosition;
+        
+        for(int i = 0; i < numSamples; i++) {
+            const Vec x = interleaved[i * numGroups + group];
+            
+            // True peak, the history is stored twice so the taps can always be read contiguously
+            history[position] = x;
+            history[position + TRUE_PEAK_TAPS] = x;
+            position = (position + 1) % TRUE_PEAK_TAPS;
+            
+            for(int phase = 0; phase < TRUE_PEAK_PHASES; phase++) {
+                const Vec *coefficients = truePeakCoefficients.getData() + phase * TRUE_PEAK_TAPS;
+                Vec y = Vec::expand(0.0f);
+                
+                for(int tap = 0; tap < TRUE_PEAK_TAPS; tap++)
+                    y = Vec::multiplyAdd(y, coefficients[tap], history[position + tap]);
+                
+                peak = Vec::max(peak, Vec::abs(y));
+            }
+            
+            // K-weighting, transposed direct form II
+            const Vec y1 = shelf.b0 * x + s1;
+            s1 = shelf.b1 * x - shelf.a1 * y1 + s2;
+            s2 = shelf.b2 * x - shelf.a2 * y1;
+            
+            const Vec y2 = highPass.b0 * y1 + s3;
+            s3 = highPass.b1 * y1 - highPass.a1 * y2 + s4;
+            s4 = highPass.b2 * y1 - highPass.a2 * y2;
+            
+            sum += y2 * y2;
+        }
+        
+        filterState[group * 4] = s1;
+        filterState[group * 4 + 1] = s2;
+        filterState[group * 4 + 2] = s3;
+        filterState[group * 4 + 3] = s4;
+        energy[group] = sum;
+        peaks[group] = peak;
+    }
+    
+    historyPosition = position;
+}
+
+/*
+ Closes a 100 ms sub block: updates the momentary and short term windows and feeds
+ every complete 400 ms gating block into the histogram
+ */
+void LoudnessMeter::endSubBlock() {
+    double power = 0.0;
+    float peak = 0.0f;
+    
+    for(int group = 0; group < numGroups; group++)
+        power += (energy[group] * weights[group]).sum();
+    energy.clear();
+    
+    for(int channel = 0; channel < numChannels; channel++)
+        peak = jmax(peak, peaks.getRawData()[channel]);
+    
+    subBlockPower[subBlockIndex] = power / subBlockLength;
+    subBlockIndex = (subBlockIndex + 1) % LOUDNESS_SHORT_TERM_BLOCKS;
+    subBlocksSeen++;
+    samplesInSubBlock = 0;
+    
+    double momentaryPower = 0.0;
+    double shortTermPower = 0.0;
+    const int momentaryBlocks = jmin(subBlocksSeen, LOUDNESS_MOMENTARY_BLOCKS);
+    const int shortTermBlocks = jmin(subBlocksSeen, LOUDNESS_SHORT_TERM_BLOCKS);
+    
+    for(int i = 1; i <= shortTermBlocks; i++) {
+        const double blockPower = subBlockPower[(subBlockIndex - i + LOUDNESS_SHORT_TERM_BLOCKS) % LOUDNESS_SHORT_TERM_BLOCKS];
+        
+        if(i <= momentaryBlocks)
+            momentaryPower += blockPower;
+        shortTermPower += blockPower;
+    }
+    momentaryPower /= momentaryBlocks;
+    shortTermPower /= shortTermBlocks;
+    
+    momentary = powerToLoudness(momentaryPower);
+    shortTerm = powerToLoudness(shortTermPower);
+    truePeak = peak > 0.0f ? Decibels::gainToDecibels(peak, LOUDNESS_SILENCE) : LOUDNESS_SILENCE;
+    
+    // Gating blocks overlap by 75%, so each complete sub block closes a new one
+    if(subBlocksSeen >= LOUDNESS_MOMENTARY_BLOCKS) {
+        const float blockLoudness = momentary.get();
+        
+        // Each bin keeps a count and the summed power of its blocks, so the memory used never grows
+        if(blockLoudness >= -70.0f) {
+            const int bin = jlimit(0, LOUDNESS_HISTOGRAM_BINS - 1, (int) ((blockLoudness + 70.0f) * 10.0f));
+            histogram[bin]++;
+            histogramPower[bin] += momentaryPower;
+            updateIntegratedLoudness();
+        }
+    }
+}
+
+/*
+ Applies the relative gate to the histogram of gating blocks, constant cost however long the meter has run
+ */
+void LoudnessMeter::updateIntegratedLoudness() {
+    double total = 0.0;
+    int64 count = 0;
+    
+    for(int i = 0; i < LOUDNESS_HISTOGRAM_BINS; i++) {
+        total += histogramPower[i];
+        count += histogram[i];
+    }
+    
+    if(count == 0)
+        return;
+    
+    const double relativeGate = powerToLoudness(total / count) - 10.0;
+    const int firstBin = jlimit(0, LOUDNESS_HISTOGRAM_BINS, roundToInt((relativeGate + 70.0) * 10.0));
+    
+    total = 0.0;
+    count = 0;
+    for(int i = firstBin; i < LOUDNESS_HISTOGRAM_BINS; i++) {
+        total += histogramPower[i];
+        count += histogram[i];
+    }
+    
+    if(count > 0)
+        integrated = powerToLoudness(total / count);
+}
+
+/*
+ Clears the filters, windows and histogram
+ */
+void LoudnessMeter::clearState() {
+    filterState.clear();
+    energy.clear();
+    peaks.clear();
+    peakHistory.clear();
+    historyPosition = 0;
+    samplesInSubBlock = 0;
+    
+    for(int i = 0; i < LOUDNESS_SHORT_TERM_BLOCKS; i++)
+        subBlockPower[i] = 0.0;
+    subBlockIndex = 0;
+    subBlocksSeen = 0;
+    
+    for(int i = 0; i < LOUDNESS_HISTOGRAM_BINS; i++) {
+        histogram[i] = 0;
+        histogramPower[i] = 0.0;
+    }
+    
+    momentary = LOUDNESS_SILENCE;
+    shortTerm = LOUDNESS_SILENCE;
+    integrated = LOUDNESS_SILENCE;
+    truePeak = LOUDNESS_SILENCE;
+}
+
+/*
+ Converts a weighted mean square to LUFS
+ */
+float LoudnessMeter::powerToLoudness(double power) {
+    if(power <= 0.0)
+        return LOUDNESS_SILENCE;
+    return jmax(LOUDNESS_SILENCE, (float) (-0.691 + 10.0 * std::log10(power)));
+}
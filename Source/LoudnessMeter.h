@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.h
+    Created: 19 Oct 2026 10:48:19am
+    Author:  Esteban Cambronero
+    EBU R128 / ITU-R BS.1770 loudness meter run as an analysis stage
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AnalysisStage.h"
+#include "SIMDArray.h"
+
+#define LOUDNESS_MAX_CHANNELS 16
+#define LOUDNESS_SHORT_TERM_BLOCKS 30        // 3 s of 100 ms sub blocks
+#define LOUDNESS_MOMENTARY_BLOCKS 4          // 400 ms of 100 ms sub blocks
+#define LOUDNESS_HISTOGRAM_BINS 750          // -70 LUFS to +5 LUFS in 0.1 LU steps
+#define LOUDNESS_SILENCE -100.0f
+#define TRUE_PEAK_PHASES 4
+#define TRUE_PEAK_TAPS 12
+
+class LoudnessMeter : public AnalysisStage
+{
+public:
+    LoudnessMeter();
+    void prepare(double sampleRate, int numChannels, int maxBlockSize) override;
+    void process(const AudioBuffer<float> &block, int numSamples) override;
+    void reset();
+    void setChannelWeight(int channel, float weight);
+    float getMomentaryLoudness() const;
+    float getShortTermLoudness() const;
+    float getIntegratedLoudness() const;
+    float getTruePeak() const;
+private:
+    typedef dsp::SIMDRegister<float> Vec;
+    struct Biquad {
+        Vec b0, b1, b2, a1, a2;
+    };
+    void setupKWeighting(double sampleRate);
+    void interleave(const AudioBuffer<float> &block, int start, int numSamples);
+    void processChunk(int numSamples);
+    void endSubBlock();
+    void updateIntegratedLoudness();
+    void clearState();
+    static float powerToLoudness(double power);
+    
+    int numChannels;
+    int numGroups;
+    int subBlockLength;
+    int samplesInSubBlock;
+    
+    // Channels are interleaved into SIMD registers so every filter runs on several channels at once
+    SIMDArray<float> interleaved;
+    SIMDArray<float> filterState;
+    SIMDArray<float> energy;
+    SIMDArray<float> weights;
+    SIMDArray<float> peakHistory;
+    SIMDArray<float> peaks;
+    SIMDArray<float> truePeakCoefficients;
+    int historyPosition;
+    Biquad shelf;
+    Biquad highPass;
+    float channelWeights[LOUDNESS_MAX_CHANNELS];
+    
+    // Gating
+    double subBlockPower[LOUDNESS_SHORT_TERM_BLOCKS];
+    int subBlockIndex;
+    int subBlocksSeen;
+    int64 histogram[LOUDNESS_HISTOGRAM_BINS];
+    double histogramPower[LOUDNESS_HISTOGRAM_BINS];
+    
+    Atomic<float> momentary;
+    Atomic<float> shortTerm;
+    Atomic<float> integrated;
+    Atomic<float> truePeak;
+    Atomic<int> resetRequested;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoudnessMeter)
+};
@@ -10,6 +10,7 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "MainComponent.h"
+#include "HeadlessRenderer.h"
 
 //==============================================================================
 class FinalProjectApplication  : public JUCEApplication
@@ -27,6 +28,23 @@ public:
     {
         // This method is where you should put your application's initialisation code..
 
+        // Rendering to images from the command line skips the main window
+        const ArgumentList arguments (getApplicationName(), getCommandLineParameterArray());
+
+        if (HeadlessRenderer::isRequested (arguments))
+        {
+            headlessRenderer.reset (new HeadlessRenderer());
+            const String error = headlessRenderer->start (arguments);
+
+            if (error.isNotEmpty())
+            {
+                Logger::writeToLog (error);
+                setApplicationReturnValue (1);
+                quit();
+            }
+            return;
+        }
+
         mainWindow.reset (new MainWindow (getApplicationName()));
     }
 
@@ -35,6 +53,7 @@ public:
         // Add your application's shutdown code here..
 
         mainWindow = nullptr; // (deletes our window)
+        headlessRenderer = nullptr;
     }
 
     //==============================================================================
@@ -99,6 +118,7 @@ public:
 
 private:
     std::unique_ptr<MainWindow> mainWindow;
+    std::unique_ptr<HeadlessRenderer> headlessRenderer;
 };
 
 //==============================================================================
@@ -13,6 +13,13 @@
 MainComponent::MainComponent() : audioIOSelector(deviceManager, 1, 2, 0, 0, false, false, true, true)
 {
     audioFileEnabled = false;
+    analysisThread = nullptr;
+    circBuffer = nullptr;
+    twoDVisualizer = nullptr;
+    circMesh = nullptr;
+    lineMesh = nullptr;
+    triangleMesh = nullptr;
+    squareMesh = nullptr;
     
     //Audio Setup
     state = AudioState::STOPPED;
@@ -26,6 +33,8 @@ MainComponent::MainComponent() : audioIOSelector(deviceManager, 1, 2, 0, 0, fals
     // Make sure you set the size of the component after
     // you add any child components.
     setSize (800, 600);
+    
+    startTimerHz(10);
 
     // Some platforms require permissions to open input channels so request that here
     if (RuntimePermissions::isRequired (RuntimePermissions::recordAudio)
@@ -62,20 +71,16 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
     
     circBuffer = new CircularBuffer(2, samplesPerBlockExpected*10);
     
-    twoDVisualizer = new SineVisualizer(circBuffer);
-    addChildComponent(twoDVisualizer);
-    
-    circMesh = new CircularMesh(circBuffer, "circle");
-    addChildComponent(circMesh);
-    
-    lineMesh = new CircularMesh(circBuffer, "line");
-    addChildComponent(lineMesh);
-    
-    triangleMesh = new CircularMesh(circBuffer, "triangle");
-    addChildComponent(triangleMesh);
+    analysisThread = new AnalysisThread(circBuffer, sampleRate);
+    analysisThread->addStage(spectrumBus);
+    analysisThread->addStage(&loudnessMeter);
+    analysisThread->addStage(&pitchDetector);
+    analysisThread->addStage(&stereoAnalyzer);
+    analysisThread->addListener(this);
+    analysisThread->startThread();
     
-    squareMesh = new CircularMesh(circBuffer, "square");
-    addChildComponent(squareMesh);
+    // Visualizers are only created when their button is first pressed
+    updateSpectrumSources();
 }
 
 void MainComponent::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
@@ -106,40 +111,47 @@ void MainComponent::releaseResources()
     if (lineMesh!= nullptr)
       {
           lineMesh->stop();
-          removeChildComponent (lineMesh);
           delete lineMesh;
+          lineMesh = nullptr;
       }
       
       if (circMesh != nullptr)
       {
           circMesh->stop();
-          removeChildComponent (circMesh);
           delete circMesh;
+          circMesh = nullptr;
       }
       
       if (twoDVisualizer != nullptr)
       {
           twoDVisualizer->stop();
-          removeChildComponent (twoDVisualizer);
           delete twoDVisualizer;
+          twoDVisualizer = nullptr;
       }
     
     if (squareMesh!= nullptr)
     {
         squareMesh->stop();
-        removeChildComponent (squareMesh);
         delete squareMesh;
+        squareMesh = nullptr;
     }
     
     if (triangleMesh!= nullptr)
     {
         triangleMesh->stop();
-        removeChildComponent (triangleMesh);
         delete triangleMesh;
+        triangleMesh = nullptr;
     }
       
+      if (analysisThread != nullptr)
+      {
+          delete analysisThread;
+          analysisThread = nullptr;
+      }
+      
       audioSource.releaseResources();
       delete circBuffer;
+      circBuffer = nullptr;
 }
 
 //==============================================================================
@@ -163,6 +175,15 @@ void MainComponent::resized()
     int bMargin = 10;
     
     resizeButtons(bWidth, bHeight, bMargin);
+    meterLabel.setBounds(bMargin, 100, bWidth, bHeight);
+    analysisSourceBox.setBounds(bWidth + 2 * bMargin, 100, 2 * bWidth / 3, bHeight);
+    layerModeBox.setBounds(bWidth + 2 * bMargin + 2 * bWidth / 3 + bMargin / 3, 100, bWidth / 3 - bMargin / 3, bHeight);
+    meshStyleBox.setBounds(bMargin, 130, bWidth / 3 - bMargin / 3, bHeight);
+    meshResolutionBox.setBounds(bMargin + bWidth / 3, 130, bWidth / 3 - bMargin / 3, bHeight);
+    performanceButton.setBounds(bMargin + 2 * bWidth / 3, 130, bWidth / 3, bHeight);
+    benchmarkButton.setBounds(bWidth + 2 * bMargin, 130, bWidth / 3, bHeight);
+    framePacingBox.setBounds(bWidth + 2 * bMargin + bWidth / 3 + bMargin / 3, 130, bWidth / 3 - bMargin / 3, bHeight);
+    waveformLengthBox.setBounds(bWidth + 2 * bMargin + 2 * bWidth / 3 + bMargin / 3, 130, bWidth / 3 - bMargin / 3, bHeight);
     
     //Visualizers
     resizeVisualizers(width, height);
@@ -171,7 +192,10 @@ void MainComponent::resized()
 /*
  Sets up the GUI mainly the text buttons and connects them to the main component
  */
-void MainComponent::setupGUI(Listener *mainComponent) {
+void MainComponent::setupGUI(Button::Listener *mainComponent) {
+    //Visualizers are drawn by the render host, it is sized to the area below the controls
+    addAndMakeVisible(&renderHost);
+    
     //Open file
     addAndMakeVisible(&openFileButton);
     openFileButton.setButtonText("Open File");
@@ -226,6 +250,75 @@ void MainComponent::setupGUI(Listener *mainComponent) {
     triangleVisualizer.setColour(TextButton::buttonColourId, Colours::floralwhite);
     triangleVisualizer.addListener(mainComponent);
     triangleVisualizer.setToggleState(false, NotificationType::dontSendNotification);
+    
+    //Meter Readout
+    addAndMakeVisible(&meterLabel);
+    meterLabel.setJustificationType(Justification::centredLeft);
+    meterLabel.setFont(Font(14.0f));
+    meterLabel.setMinimumHorizontalScale(0.5f);
+    
+    //Analysis Source Selection
+    addAndMakeVisible(&analysisSourceBox);
+    analysisSourceBox.addItem("FFT Spectrum", FFT_SPECTRUM);
+    analysisSourceBox.addItem("Chroma", CHROMA);
+    analysisSourceBox.addItem("Monitored Frequencies", GOERTZEL_BANK);
+    analysisSourceBox.addItem("Multi-Resolution Spectrum", MULTI_RESOLUTION);
+    analysisSourceBox.addItem("Stereo Width", STEREO_WIDTH);
+    analysisSourceBox.addItem("Sliding DFT", SLIDING_DFT);
+    analysisSourceBox.setSelectedId(FFT_SPECTRUM, NotificationType::dontSendNotification);
+    analysisSourceBox.addListener(this);
+    
+    //Channel Layer Selection
+    addAndMakeVisible(&layerModeBox);
+    layerModeBox.addItem("Summed", CircularMesh::SINGLE_LAYER);
+    layerModeBox.addItem("Interleaved", CircularMesh::INTERLEAVED_LAYERS);
+    layerModeBox.addItem("Stacked", CircularMesh::STACKED_LAYERS);
+    layerModeBox.addItem("Split", CircularMesh::SPLIT_LAYERS);
+    layerModeBox.setSelectedId(CircularMesh::SINGLE_LAYER, NotificationType::dontSendNotification);
+    layerModeBox.addListener(this);
+    
+    //Mesh Draw Mode and Resolution Selection
+    addAndMakeVisible(&meshStyleBox);
+    meshStyleBox.addItem("Points", CircularMesh::POINTS_MODE);
+    meshStyleBox.addItem("Surface", CircularMesh::SURFACE_MODE);
+    meshStyleBox.setSelectedId(CircularMesh::POINTS_MODE, NotificationType::dontSendNotification);
+    meshStyleBox.addListener(this);
+    
+    addAndMakeVisible(&meshResolutionBox);
+    const int resolutions[] = { MESH_DEFAULT_RESOLUTION, 256, 512, 1024, MESH_MAX_RESOLUTION };
+    for(int resolution : resolutions)
+        meshResolutionBox.addItem(String(resolution) + " x " + String(resolution + 1), resolution);
+    meshResolutionBox.setSelectedId(MESH_DEFAULT_RESOLUTION, NotificationType::dontSendNotification);
+    meshResolutionBox.addListener(this);
+    
+    //Performance Overlay
+    addAndMakeVisible(&performanceButton);
+    performanceButton.setButtonText("Performance");
+    performanceButton.addListener(mainComponent);
+    
+    //Benchmark
+    addAndMakeVisible(&benchmarkButton);
+    benchmarkButton.setButtonText("Benchmark");
+    benchmarkButton.addListener(mainComponent);
+    
+    //Frame Pacing Selection
+    addAndMakeVisible(&framePacingBox);
+    framePacingBox.addItem("Continuous", CONTINUOUS_VSYNC);
+    framePacingBox.addItem("Analysis, max 60 fps", ANALYSIS_60_FPS);
+    framePacingBox.addItem("Analysis, max 30 fps", ANALYSIS_30_FPS);
+    framePacingBox.addItem("Analysis no vsync", ANALYSIS_UNCAPPED);
+    framePacingBox.setSelectedId(ANALYSIS_60_FPS, NotificationType::dontSendNotification);
+    framePacingBox.addListener(this);
+    updateFramePacing();
+    
+    //Waveform Window Length Selection
+    addAndMakeVisible(&waveformLengthBox);
+    waveformLengthBox.addItem("256 samples", SINE_DEFAULT_WINDOW_LENGTH);
+    waveformLengthBox.addItem("4096 samples", 4096);
+    waveformLengthBox.addItem("64K samples", 1 << 16);
+    waveformLengthBox.addItem("1M samples", SINE_MAX_WINDOW_LENGTH);
+    waveformLengthBox.setSelectedId(SINE_DEFAULT_WINDOW_LENGTH, NotificationType::dontSendNotification);
+    waveformLengthBox.addListener(this);
 
 }
 
@@ -271,6 +364,19 @@ void MainComponent::buttonClicked(Button *buttonClicked) {
     else if(buttonClicked == &lineVisualizer) lineVisualizerClicked(buttonClicked);
     else if(buttonClicked == &squareVisualizer) squareVisualizerClicked(buttonClicked);
     else if(buttonClicked == &triangleVisualizer) triangleVisualizerClicked(buttonClicked);
+    else if(buttonClicked == &benchmarkButton) benchmarkMeshes();
+    else if(buttonClicked == &performanceButton) updatePerformanceOverlays();
+}
+
+/*
+ Overriden function that handles the analysis source selection
+ */
+void MainComponent::comboBoxChanged(ComboBox *comboBoxThatHasChanged) {
+    if(comboBoxThatHasChanged == &analysisSourceBox) updateSpectrumSources();
+    else if(comboBoxThatHasChanged == &layerModeBox) updateLayerModes();
+    else if(comboBoxThatHasChanged == &meshStyleBox || comboBoxThatHasChanged == &meshResolutionBox) updateMeshStyles();
+    else if(comboBoxThatHasChanged == &waveformLengthBox) updateWaveformLength();
+    else if(comboBoxThatHasChanged == &framePacingBox) updateFramePacing();
 }
 /*
  Changes the audioState to the new state
@@ -279,6 +385,9 @@ void MainComponent::changeAudioState(MainComponent::AudioState newState) {
     if(state != newState) {
         state = newState;
         
+        // Nothing new is drawn unless the audio is playing
+        renderHost.setTransportRunning(state == PLAYING);
+        
         switch (state) {
             case STOPPED:
                 playButton.setButtonText("Play");
@@ -325,6 +434,7 @@ void MainComponent::openFile() {
             playButton.setEnabled(true);
             readerSource = newSource.release();
             audioFileEnabled = true;
+            loudnessMeter.reset();
         }
     }
 }
@@ -358,19 +468,12 @@ void MainComponent::twoDButtonClicked(Button *&buttonClicked) {
      squareVisualizer.setToggleState(false, NotificationType::dontSendNotification);
      lineVisualizer.setToggleState(false, NotificationType::dontSendNotification);
     
-     twoDVisualizer->setVisible(buttonToggleState);
-     squareMesh->setVisible(false);
-     lineMesh->setVisible(false);
-     circMesh->setVisible(false);
-     triangleMesh->setVisible(false);
-     
-     twoDVisualizer->start();
-     triangleMesh->stop();
-     circMesh->stop();
-     squareMesh->stop();
-     lineMesh->stop();
-     
-     resized();
+     if(twoDVisualizer == nullptr && circBuffer != nullptr) {
+         twoDVisualizer = new SineVisualizer(renderHost, circBuffer);
+         updateWaveformLength();
+         updatePerformanceOverlays();
+     }
+     showVisualizer(twoDVisualizer, buttonToggleState);
 }
 
 /*
@@ -385,19 +488,7 @@ void MainComponent::circVisualizerClicked(Button *&buttonClicked) {
      squareVisualizer.setToggleState(false, NotificationType::dontSendNotification);
      lineVisualizer.setToggleState(false, NotificationType::dontSendNotification);
     
-     circMesh->setVisible(buttonToggleState);
-     squareMesh->setVisible(false);
-     lineMesh->setVisible(false);
-     triangleMesh->setVisible(false);
-     twoDVisualizer->setVisible(false);
-     
-     circMesh->start();
-     twoDVisualizer->stop();
-     triangleMesh->stop();
-     squareMesh->stop();
-     lineMesh->stop();
-     
-     resized();
+     showVisualizer(createMesh(circMesh, "circle"), buttonToggleState);
 }
 
 /*
@@ -411,19 +502,8 @@ void MainComponent::lineVisualizerClicked(Button *&buttonClicked) {
      squareVisualizer.setToggleState(false, NotificationType::dontSendNotification);
      triangleVisualizer.setToggleState(false, NotificationType::dontSendNotification);
     
-     lineMesh->setVisible(buttonToggleState);
-     squareMesh->setVisible(false);
-     triangleMesh->setVisible(false);
-     circMesh->setVisible(false);
-     twoDVisualizer->setVisible(false);
-     
-     lineMesh->start();
-     twoDVisualizer->stop();
-     circMesh->stop();
-     squareMesh->stop();
-     triangleMesh->stop();
-     
-     resized();}
+     showVisualizer(createMesh(lineMesh, "line"), buttonToggleState);
+}
 
 /*
 Function that specifies behavior if the 3D Square Visualizer button is pressed
@@ -437,19 +517,7 @@ void MainComponent::squareVisualizerClicked(Button *&buttonClicked) {
      triangleVisualizer.setToggleState(false, NotificationType::dontSendNotification);
      lineVisualizer.setToggleState(false, NotificationType::dontSendNotification);
     
-     squareMesh->setVisible(buttonToggleState);
-     triangleMesh->setVisible(false);
-     lineMesh->setVisible(false);
-     circMesh->setVisible(false);
-     twoDVisualizer->setVisible(false);
-     
-     squareMesh->start();
-     twoDVisualizer->stop();
-     circMesh->stop();
-     triangleMesh->stop();
-     lineMesh->stop();
-     
-     resized();
+     showVisualizer(createMesh(squareMesh, "square"), buttonToggleState);
 }
 
 /*
@@ -463,17 +531,45 @@ void MainComponent::triangleVisualizerClicked(Button *&buttonClicked) {
     squareVisualizer.setToggleState(false, NotificationType::dontSendNotification);
     lineVisualizer.setToggleState(false, NotificationType::dontSendNotification);
    
-    triangleMesh->setVisible(buttonToggleState);
-    squareMesh->setVisible(false);
-    lineMesh->setVisible(false);
-    circMesh->setVisible(false);
-    twoDVisualizer->setVisible(false);
-    
-    triangleMesh->start();
-    twoDVisualizer->stop();
-    circMesh->stop();
-    squareMesh->stop();
-    lineMesh->stop();
+    showVisualizer(createMesh(triangleMesh, "triangle"), buttonToggleState);
+}
+
+/*
+ Creates a mesh the first time it is needed, set up with the current analysis source and layer mode
+ Returns nullptr until the audio has started, as there is no circular buffer to draw from before then
+ */
+CircularMesh *MainComponent::createMesh(CircularMesh *&mesh, const char *type) {
+    if(mesh == nullptr && circBuffer != nullptr) {
+        mesh = new CircularMesh(renderHost, circBuffer, type);
+        updateSpectrumSources();
+        updateLayerModes();
+        updateMeshStyles();
+        updatePerformanceOverlays();
+    }
+    return mesh;
+}
+
+/*
+ Shows one visualizer and hides and stops every other one that has been created
+ Hidden visualizers keep their GL objects until the render host releases them, so switching back is immediate
+ */
+void MainComponent::showVisualizer(RenderPass *visualizer, bool shouldShow) {
+    RenderPass *visualizers[] = { twoDVisualizer, circMesh, lineMesh, triangleMesh, squareMesh };
+    
+    for(RenderPass *other : visualizers) {
+        if(other != nullptr && other != visualizer) {
+            other->setVisible(false);
+            other->stop();
+        }
+    }
+    
+    if(visualizer != nullptr) {
+        visualizer->setVisible(shouldShow);
+        if(shouldShow)
+            visualizer->start();
+        else
+            visualizer->stop();
+    }
     
     resized();
 }
@@ -483,16 +579,191 @@ void MainComponent::triangleVisualizerClicked(Button *&buttonClicked) {
  Resizes visualizers after checking if the
  */
 void MainComponent::resizeVisualizers(int width, int height) {
+    renderHost.setBounds(0, 160, width, height-160);
+    const Rectangle<int> area = renderHost.getLocalBounds();
+    
     if(twoDVisualizer != nullptr)
-        twoDVisualizer->setBounds(0, 100, width, height-100);
+        twoDVisualizer->setBounds(area);
     if(circMesh != nullptr)
-        circMesh->setBounds(0, 100, width, height-100);
+        circMesh->setBounds(area);
     if(lineMesh != nullptr)
-        lineMesh->setBounds(0, 100, width, height-100);
+        lineMesh->setBounds(area);
     if(triangleMesh != nullptr)
-        triangleMesh->setBounds(0, 100, width, height-100);
+        triangleMesh->setBounds(area);
     if(squareMesh != nullptr)
-        squareMesh->setBounds(0, 100, width, height-100);
+        squareMesh->setBounds(area);
+}
+
+/*
+ Points every mesh at the analysis selected in the source box
+ Stages that only feed the meshes are kept off the analysis thread while they are not selected
+ */
+void MainComponent::updateSpectrumSources() {
+    SpectrumSource *source = nullptr;
+    int selected = analysisSourceBox.getSelectedId();
+    
+    if(selected == CHROMA)
+        source = &pitchDetector;
+    else if(selected == GOERTZEL_BANK)
+        source = &goertzelBank;
+    else if(selected == MULTI_RESOLUTION)
+        source = &multiResolutionSpectrum;
+    else if(selected == STEREO_WIDTH)
+        source = &stereoAnalyzer;
+    else if(selected == SLIDING_DFT)
+        source = &slidingDFT;
+    
+    setStageActive(&goertzelBank, selected == GOERTZEL_BANK);
+    setStageActive(&multiResolutionSpectrum, selected == MULTI_RESOLUTION);
+    setStageActive(&slidingDFT, selected == SLIDING_DFT);
+    
+    if(circMesh != nullptr)
+        circMesh->setSpectrumSource(source);
+    if(lineMesh != nullptr)
+        lineMesh->setSpectrumSource(source);
+    if(triangleMesh != nullptr)
+        triangleMesh->setSpectrumSource(source);
+    if(squareMesh != nullptr)
+        squareMesh->setSpectrumSource(source);
+}
+
+/*
+ Lays out the channel spectra of every mesh as selected in the layer box
+ */
+void MainComponent::updateLayerModes() {
+    CircularMesh::LayerMode mode = (CircularMesh::LayerMode) layerModeBox.getSelectedId();
+    
+    if(circMesh != nullptr)
+        circMesh->setLayerMode(mode);
+    if(lineMesh != nullptr)
+        lineMesh->setLayerMode(mode);
+    if(triangleMesh != nullptr)
+        triangleMesh->setLayerMode(mode);
+    if(squareMesh != nullptr)
+        squareMesh->setLayerMode(mode);
+}
+
+/*
+ Sets every mesh to the draw mode and resolution selected in the mesh boxes
+ */
+void MainComponent::updateMeshStyles() {
+    CircularMesh::DrawMode mode = (CircularMesh::DrawMode) meshStyleBox.getSelectedId();
+    int resolution = meshResolutionBox.getSelectedId();
+    CircularMesh *meshes[] = { circMesh, lineMesh, triangleMesh, squareMesh };
+    
+    for(CircularMesh *mesh : meshes) {
+        if(mesh != nullptr) {
+            mesh->setDrawMode(mode);
+            mesh->setResolution(resolution);
+        }
+    }
+}
+
+/*
+ Sets the number of samples the waveform shows across the view to the one selected in the waveform box
+ */
+void MainComponent::updateWaveformLength() {
+    if(twoDVisualizer != nullptr)
+        twoDVisualizer->setWindowLength(waveformLengthBox.getSelectedId());
+}
+
+/*
+ Sets how the visualizers' frames are paced to the one selected in the pacing box
+ The analysis pacings only draw when a block has been analysed, no faster than their cap
+ */
+void MainComponent::updateFramePacing() {
+    switch(framePacingBox.getSelectedId()) {
+        case CONTINUOUS_VSYNC:
+            renderHost.setPacingMode(RenderHost::CONTINUOUS_PACING);
+            renderHost.setSwapInterval(1);
+            break;
+        case ANALYSIS_30_FPS:
+            renderHost.setPacingMode(RenderHost::ANALYSIS_PACING);
+            renderHost.setFrameRateCap(30);
+            renderHost.setSwapInterval(1);
+            break;
+        case ANALYSIS_UNCAPPED:
+            renderHost.setPacingMode(RenderHost::ANALYSIS_PACING);
+            renderHost.setFrameRateCap(0);
+            renderHost.setSwapInterval(0);
+            break;
+        default:
+            renderHost.setPacingMode(RenderHost::ANALYSIS_PACING);
+            renderHost.setFrameRateCap(60);
+            renderHost.setSwapInterval(1);
+            break;
+    }
+}
+
+/*
+ Shows or hides the performance overlay on every visualizer as the performance button is ticked
+ */
+void MainComponent::updatePerformanceOverlays() {
+    const bool shouldShow = performanceButton.getToggleState();
+    CircularMesh *meshes[] = { circMesh, lineMesh, triangleMesh, squareMesh };
+    
+    for(CircularMesh *mesh : meshes)
+        if(mesh != nullptr)
+            mesh->setPerformanceOverlay(shouldShow);
+    
+    if(twoDVisualizer != nullptr)
+        twoDVisualizer->setPerformanceOverlay(shouldShow);
+}
+
+/*
+ Called on the analysis thread after every block, the stages have published their frames so the visualizers can draw them
+ */
+void MainComponent::analysisBlockProcessed() {
+    renderHost.frameAvailable();
+}
+
+/*
+ Starts the frame time benchmark on the mesh being shown, the results appear in its status label
+ */
+void MainComponent::benchmarkMeshes() {
+    CircularMesh *meshes[] = { circMesh, lineMesh, triangleMesh, squareMesh };
+    
+    for(CircularMesh *mesh : meshes)
+        if(mesh != nullptr && mesh->isVisible())
+            mesh->startBenchmark();
+}
+
+/*
+ Adds or removes a stage on the analysis thread, if there is one
+ */
+void MainComponent::setStageActive(AnalysisStage *stage, bool active) {
+    if(analysisThread == nullptr)
+        return;
+    
+    if(active)
+        analysisThread->addStage(stage);
+    else
+        analysisThread->removeStage(stage);
+}
+
+/*
+ Formats a loudness reading, anything at the meter floor is shown as silence
+ */
+static String formatLoudness(float value, const char *unit) {
+    if(value <= LOUDNESS_SILENCE)
+        return String("-inf ") + unit;
+    return String(value, 1) + " " + unit;
+}
+
+/*
+ Refreshes the meter readout from the values published by the analysis thread
+ */
+void MainComponent::timerCallback() {
+    float fundamental = pitchDetector.getFundamental();
+    
+    meterLabel.setText("M: " + formatLoudness(loudnessMeter.getMomentaryLoudness(), "LUFS")
+                       + "  S: " + formatLoudness(loudnessMeter.getShortTermLoudness(), "LUFS")
+                       + "  I: " + formatLoudness(loudnessMeter.getIntegratedLoudness(), "LUFS")
+                       + "  TP: " + formatLoudness(loudnessMeter.getTruePeak(), "dBTP")
+                       + "  F0: " + (fundamental > 0.0f ? String(fundamental, 1) + " Hz" : String("--"))
+                       + "  Corr: " + String(stereoAnalyzer.getCorrelation(), 2)
+                       + "  Bal: " + String(stereoAnalyzer.getBalance(), 2),
+                       dontSendNotification);
 }
 
 
@@ -12,12 +12,21 @@
 #include "CircularBuffer.h"
 #include "SineVisualizer.h"
 #include "CircularMesh.h"
+#include "AnalysisThread.h"
+#include "LoudnessMeter.h"
+#include "PitchDetector.h"
+#include "GoertzelBank.h"
+#include "MultiResolutionSpectrum.h"
+#include "StereoAnalyzer.h"
+#include "SlidingDFT.h"
+#include "SpectrumBus.h"
+#include "RenderHost.h"
 //==============================================================================
 /*
     This component lives inside our window, and this is where you should put all
     your controls and content.
 */
-class MainComponent   : public AudioAppComponent, public ChangeListener, public Button::Listener
+class MainComponent   : public AudioAppComponent, public ChangeListener, public Button::Listener, public ComboBox::Listener, private AnalysisThread::Listener, private Timer
 
 {
 public:
@@ -35,6 +44,7 @@ public:
     void resized() override;
     
     void buttonClicked(Button *buttonClicked) override;
+    void comboBoxChanged(ComboBox *comboBoxThatHasChanged) override;
 
 private:
     //==============================================================================
@@ -47,6 +57,20 @@ private:
         PAUSED,
         STOPPING
     };
+    enum FramePacing {
+        CONTINUOUS_VSYNC = 1,
+        ANALYSIS_60_FPS,
+        ANALYSIS_30_FPS,
+        ANALYSIS_UNCAPPED
+    };
+    enum AnalysisSource {
+        FFT_SPECTRUM = 1,
+        CHROMA,
+        GOERTZEL_BANK,
+        MULTI_RESOLUTION,
+        STEREO_WIDTH,
+        SLIDING_DFT
+    };
     bool audioFileEnabled;
     
     //GUI BUTTONS
@@ -62,6 +86,16 @@ private:
     
     AudioDeviceSelectorComponent audioIOSelector;
     
+    Label meterLabel;
+    ComboBox analysisSourceBox;
+    ComboBox layerModeBox;
+    ComboBox meshStyleBox;
+    ComboBox meshResolutionBox;
+    ToggleButton performanceButton;
+    TextButton benchmarkButton;
+    ComboBox framePacingBox;
+    ComboBox waveformLengthBox;
+    
     //Audio Reading Variables
     AudioFormatManager manager;
     ScopedPointer<AudioFormatReaderSource> readerSource;
@@ -71,7 +105,18 @@ private:
     //Circular Buffer
     CircularBuffer *circBuffer;
     
+    //Analysis
+    AnalysisThread *analysisThread;
+    LoudnessMeter loudnessMeter;
+    PitchDetector pitchDetector;
+    GoertzelBank goertzelBank;
+    MultiResolutionSpectrum multiResolutionSpectrum;
+    StereoAnalyzer stereoAnalyzer;
+    SlidingDFT slidingDFT;
+    SharedResourcePointer<SpectrumBus> spectrumBus;
+    
     //Visualizers
+    RenderHost renderHost;
     SineVisualizer *twoDVisualizer;
     CircularMesh *circMesh;
     CircularMesh *lineMesh;
@@ -87,10 +132,22 @@ private:
     void lineVisualizerClicked(Button *&buttonClicked);
     void squareVisualizerClicked(Button *&buttonClicked);
     void triangleVisualizerClicked(Button *&buttonClicked);
-    void setupGUI(Listener *mainComponent);
+    void setupGUI(Button::Listener *mainComponent);
     void resizeButtons(int bWidth, int bHeight, int bMargins);
     void changeListenerCallback(ChangeBroadcaster *source) override;
     void resizeVisualizers(int width, int height);
+    CircularMesh *createMesh(CircularMesh *&mesh, const char *type);
+    void showVisualizer(RenderPass *visualizer, bool shouldShow);
+    void updateSpectrumSources();
+    void updateLayerModes();
+    void updateMeshStyles();
+    void benchmarkMeshes();
+    void updateWaveformLength();
+    void updateFramePacing();
+    void updatePerformanceOverlays();
+    void analysisBlockProcessed() override;
+    void setStageActive(AnalysisStage *stage, bool active);
+    void timerCallback() override;
     
 
 
@@ -0,0 +1,210 @@
+/*
+  ==============================================================================
+
+    MultiResolutionSpectrum.cpp
+    Created: 19 Oct 2026 4:20:44pm
+    Author:  Esteban Cambronero
+    Analysis stage that stitches long FFTs for the lows and short FFTs for the highs into one band array
+  ==============================================================================
+*/
+
+#include "MultiResolutionSpectrum.h"
+
+// Crossover frequencies between the resolutions, lowest (longest FFT) first
+static const double resolutionUpperFrequency[MULTIRES_NUM_RESOLUTIONS] = { 150.0, 400.0, 1200.0, 4000.0, 1.0e9 };
+
+/*
+ Constructor for the multi resolution spectrum
+ Resolution i uses an FFT of 2^(13 - i) samples with a hop of a quarter of its size, so the 512 point
+ highs update 16 times for every update of the 8192 point lows. Per sample that costs about
+ 4 * (13 + 12 + 11 + 10 + 9) operations, against 8192 * 13 / 128 for a single 8192 point FFT run at
+ the 128 sample hop of the fastest band
+ */
+MultiResolutionSpectrum::MultiResolutionSpectrum() : workers(jlimit(1, MULTIRES_NUM_RESOLUTIONS - 1, SystemStats::getNumCpus() - 1)) {
+    sampleRate = 44100.0;
+    numChannels = 0;
+    historyPosition = 0;
+    history.allocate(1 << MULTIRES_MAX_ORDER, true);
+    
+    for(int i = 0; i < MULTIRES_NUM_RESOLUTIONS; i++) {
+        Resolution &resolution = resolutions[i];
+        resolution.order = MULTIRES_MAX_ORDER - i;
+        resolution.size = 1 << resolution.order;
+        resolution.hop = resolution.size / 4;
+        resolution.samplesUntilHop = resolution.hop;
+        resolution.upperFrequency = resolutionUpperFrequency[i];
+        resolution.fft = &fftPlans->getPlan(resolution.order);
+        resolution.frame.allocate(2 * resolution.size, true);
+        resolution.window.allocate(resolution.size, true);
+        dsp::WindowingFunction<float>::fillWindowingTables(resolution.window, resolution.size, dsp::WindowingFunction<float>::hann, false);
+        
+        // Scale so a sinusoid reads as its amplitude whatever the FFT size
+        float windowSum = 0.0f;
+        for(int n = 0; n < resolution.size; n++)
+            windowSum += resolution.window[n];
+        FloatVectorOperations::multiply(resolution.window, 2.0f / windowSum, resolution.size);
+        
+        jobs.add(new ResolutionJob(*this, i));
+    }
+    
+    for(int i = 0; i < MULTIRES_NUM_BANDS; i++)
+        bands[i] = 0.0f;
+}
+
+/*
+ Destructor for the multi resolution spectrum, makes sure no job is still running
+ */
+MultiResolutionSpectrum::~MultiResolutionSpectrum() {
+    workers.removeAllJobs(true, 1000, nullptr);
+}
+
+/*
+ Lays out the log spaced bands and gives each one to the resolution that covers its centre frequency
+ Blocks are split at hop boundaries into the fixed size history, so the block size does not matter here
+ */
+void MultiResolutionSpectrum::prepare(double rate, int channels, int maxBlockSize) {
+    ignoreUnused(maxBlockSize);
+    
+    sampleRate = rate;
+    numChannels = channels;
+    historyPosition = 0;
+    history.clear(1 << MULTIRES_MAX_ORDER);
+    
+    for(int i = 0; i < MULTIRES_NUM_RESOLUTIONS; i++)
+        resolutions[i].samplesUntilHop = resolutions[i].hop;
+    
+    const double lowest = MULTIRES_LOWEST_FREQUENCY;
+    const double highest = jmin(MULTIRES_HIGHEST_FREQUENCY, 0.5 * sampleRate);
+    
+    for(int band = 0; band < MULTIRES_NUM_BANDS; band++) {
+        const double lower = lowest * std::pow(highest / lowest, (double) band / MULTIRES_NUM_BANDS);
+        const double upper = lowest * std::pow(highest / lowest, (double) (band + 1) / MULTIRES_NUM_BANDS);
+        const double centre = std::sqrt(lower * upper);
+        
+        int index = 0;
+        while(centre >= resolutions[index].upperFrequency)
+            index++;
+        
+        // Bands narrower than a bin read the nearest bin
+        const int size = resolutions[index].size;
+        const int first = jlimit(0, size / 2, roundToInt(lower * size / sampleRate));
+        const int last = jlimit(first, size / 2, roundToInt(upper * size / sampleRate) - 1);
+        
+        bandResolution[band] = index;
+        bandFirstBin[band] = first;
+        bandLastBin[band] = last;
+        bands[band] = 0.0f;
+    }
+}
+
+/*
+ Mixes the block down into the shared history, stopping at every hop boundary to run the resolutions that are due
+ */
+void MultiResolutionSpectrum::process(const AudioBuffer<float> &block, int numSamples) {
+    const int historySize = 1 << MULTIRES_MAX_ORDER;
+    const float gain = 1.0f / jmax(1, numChannels);
+    int position = 0;
+    
+    while(position < numSamples) {
+        int chunk = jmin(numSamples - position, historySize - historyPosition);
+        for(int i = 0; i < MULTIRES_NUM_RESOLUTIONS; i++)
+            chunk = jmin(chunk, resolutions[i].samplesUntilHop);
+        
+        float *dest = history + historyPosition;
+        FloatVectorOperations::copyWithMultiply(dest, block.getReadPointer(0, position), gain, chunk);
+        for(int channel = 1; channel < numChannels; channel++)
+            FloatVectorOperations::addWithMultiply(dest, block.getReadPointer(channel, position), gain, chunk);
+        
+        position += chunk;
+        historyPosition = (historyPosition + chunk) % historySize;
+        
+        for(int i = 0; i < MULTIRES_NUM_RESOLUTIONS; i++)
+            resolutions[i].samplesUntilHop -= chunk;
+        
+        runDueResolutions();
+    }
+}
+
+/*
+ One bin per band
+ */
+int MultiResolutionSpectrum::getNumBins() const {
+    return MULTIRES_NUM_BANDS;
+}
+
+/*
+ Copies the newest stitched band array, lowest band first
+ */
+int MultiResolutionSpectrum::readSpectrum(float *dest, int maxBins) {
+    results.fetch();
+    
+    const int numBins = jmin(maxBins, MULTIRES_NUM_BANDS);
+    FloatVectorOperations::copy(dest, results.getReadBuffer().bands, numBins);
+    return numBins;
+}
+
+/*
+ Runs every resolution whose hop has come round, the extra ones on the worker pool while the
+ analysis thread does the first itself, then publishes the band array once they have all finished
+ */
+void MultiResolutionSpectrum::runDueResolutions() {
+    int due[MULTIRES_NUM_RESOLUTIONS];
+    int numDue = 0;
+    
+    for(int i = 0; i < MULTIRES_NUM_RESOLUTIONS; i++) {
+        if(resolutions[i].samplesUntilHop == 0) {
+            resolutions[i].samplesUntilHop = resolutions[i].hop;
+            due[numDue++] = i;
+        }
+    }
+    
+    if(numDue == 0)
+        return;
+    
+    for(int i = 1; i < numDue; i++)
+        workers.addJob(jobs[due[i]], false);
+    
+    analyseResolution(due[0]);
+    
+    for(int i = 1; i < numDue; i++)
+        workers.waitForJobToFinish(jobs[due[i]], -1);
+    
+    Result &result = results.getWriteBuffer();
+    FloatVectorOperations::copy(result.bands, bands, MULTIRES_NUM_BANDS);
+    results.publish();
+}
+
+/*
+ Windows and transforms the newest samples for one resolution and refreshes the bands it owns
+ */
+void MultiResolutionSpectrum::analyseResolution(int index) {
+    Resolution &resolution = resolutions[index];
+    const int historySize = 1 << MULTIRES_MAX_ORDER;
+    const int start = (historyPosition - resolution.size + historySize) % historySize;
+    const int firstPart = jmin(resolution.size, historySize - start);
+    
+    FloatVectorOperations::copy(resolution.frame, history + start, firstPart);
+    FloatVectorOperations::copy(resolution.frame + firstPart, history, resolution.size - firstPart);
+    FloatVectorOperations::multiply(resolution.frame, resolution.window, resolution.size);
+    FloatVectorOperations::clear(resolution.frame + resolution.size, resolution.size);
+    
+    resolution.fft->performFrequencyOnlyForwardTransform(resolution.frame);
+    
+    for(int band = 0; band < MULTIRES_NUM_BANDS; band++) {
+        if(bandResolution[band] != index)
+            continue;
+        
+        bands[band] = FloatVectorOperations::findMaximum(resolution.frame + bandFirstBin[band], bandLastBin[band] - bandFirstBin[band] + 1);
+    }
+}
+
+/*
+ Job that runs one resolution's analysis on the worker pool
+ */
+MultiResolutionSpectrum::ResolutionJob::ResolutionJob(MultiResolutionSpectrum &spectrum, int resolutionIndex)
+    : ThreadPoolJob("Multi Resolution FFT"), owner(spectrum), index(resolutionIndex) {}
+
+ThreadPoolJob::JobStatus MultiResolutionSpectrum::ResolutionJob::runJob() {
+    owner.analyseResolution(index);
+    return jobHasFinished;
+}
@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    MultiResolutionSpectrum.h
+    Created: 19 Oct 2026 4:20:44pm
+    Author:  Esteban Cambronero
+    Analysis stage that stitches long FFTs for the lows and short FFTs for the highs into one band array
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AnalysisStage.h"
+#include "SpectrumSource.h"
+#include "FFTPlanCache.h"
+#include "TripleBuffer.h"
+
+#define MULTIRES_NUM_RESOLUTIONS 5
+#define MULTIRES_MAX_ORDER 13
+#define MULTIRES_NUM_BANDS 128
+#define MULTIRES_LOWEST_FREQUENCY 20.0
+#define MULTIRES_HIGHEST_FREQUENCY 20000.0
+
+class MultiResolutionSpectrum : public AnalysisStage, public SpectrumSource
+{
+public:
+    MultiResolutionSpectrum();
+    ~MultiResolutionSpectrum();
+    void prepare(double sampleRate, int numChannels, int maxBlockSize) override;
+    void process(const AudioBuffer<float> &block, int numSamples) override;
+    int getNumBins() const override;
+    int readSpectrum(float *dest, int maxBins) override;
+private:
+    struct Resolution {
+        int order;
+        int size;
+        int hop;
+        int samplesUntilHop;
+        double upperFrequency;
+        dsp::FFT *fft;
+        HeapBlock<float> frame;
+        HeapBlock<float> window;
+    };
+    struct Result {
+        float bands[MULTIRES_NUM_BANDS];
+    };
+    class ResolutionJob : public ThreadPoolJob
+    {
+    public:
+        ResolutionJob(MultiResolutionSpectrum &owner, int index);
+        JobStatus runJob() override;
+    private:
+        MultiResolutionSpectrum &owner;
+        int index;
+    };
+    void runDueResolutions();
+    void analyseResolution(int index);
+    
+    SharedResourcePointer<FFTPlanCache> fftPlans;
+    Resolution resolutions[MULTIRES_NUM_RESOLUTIONS];
+    OwnedArray<ResolutionJob> jobs;
+    ThreadPool workers;
+    
+    double sampleRate;
+    int numChannels;
+    HeapBlock<float> history;
+    int historyPosition;
+    
+    // Every band belongs to exactly one resolution, so the jobs never write to the same band
+    int bandResolution[MULTIRES_NUM_BANDS];
+    int bandFirstBin[MULTIRES_NUM_BANDS];
+    int bandLastBin[MULTIRES_NUM_BANDS];
+    float bands[MULTIRES_NUM_BANDS];
+    
+    TripleBuffer<Result> results;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultiResolutionSpectrum)
+};
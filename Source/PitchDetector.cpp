@@ -0,0 +1,276 @@
+/*
+  ==============================================================================
+
+    PitchDetector.cpp
+    Created: 19 Oct 2026 1:40:10pm
+    Author:  Esteban Cambronero
+    Analysis stage that tracks the fundamental (McLeod pitch method) and folds the spectrum into a chroma vector
+  ==============================================================================
+*/
+
+#include "PitchDetector.h"
+
+/*
+ Constructor for the pitch detector, the FFT plans come from the shared cache used by the spectrum path
+ */
+PitchDetector::PitchDetector() {
+    correlationFFT = &fftPlans->getPlan(PITCH_WINDOW_ORDER + 1);
+    
+    sampleRate = 44100.0;
+    numChannels = 0;
+    historyPosition = 0;
+    samplesUntilHop = PITCH_HOP_SIZE;
+    fundamental = 0.0f;
+    clarity = 0.0f;
+    
+    history.allocate(PITCH_WINDOW_SIZE, true);
+    frame.allocate(PITCH_WINDOW_SIZE, true);
+    correlation.allocate(4 * PITCH_WINDOW_SIZE, true);
+    windowed.allocate(2 * PITCH_WINDOW_SIZE + 2, true);
+    powers.allocate(PITCH_WINDOW_SIZE + 1, true);
+    squares.allocate(PITCH_WINDOW_SIZE, true);
+    energy.allocate(PITCH_WINDOW_SIZE / 2 + 2, true);
+    nsdf.allocate(PITCH_WINDOW_SIZE / 2 + 2, true);
+}
+
+/*
+ Resets the history for the new stream format
+ Blocks are consumed a hop at a time so the buffers only depend on the window size
+ */
+void PitchDetector::prepare(double rate, int channels, int maxBlockSize) {
+    ignoreUnused(maxBlockSize);
+    
+    sampleRate = rate;
+    numChannels = channels;
+    historyPosition = 0;
+    samplesUntilHop = PITCH_HOP_SIZE;
+    history.clear(PITCH_WINDOW_SIZE);
+}
+
+/*
+ Mixes the block down to mono into the history and runs an analysis every hop
+ */
+void PitchDetector::process(const AudioBuffer<float> &block, int numSamples) {
+    const float gain = 1.0f / jmax(1, numChannels);
+    int position = 0;
+    
+    while(position < numSamples) {
+        const int chunk = jmin(numSamples - position, samplesUntilHop, PITCH_WINDOW_SIZE - historyPosition);
+        float *dest = history + historyPosition;
+        
+        FloatVectorOperations::copyWithMultiply(dest, block.getReadPointer(0, position), gain, chunk);
+        for(int channel = 1; channel < numChannels; channel++)
+            FloatVectorOperations::addWithMultiply(dest, block.getReadPointer(channel, position), gain, chunk);
+        
+        position += chunk;
+        samplesUntilHop -= chunk;
+        historyPosition = (historyPosition + chunk) % PITCH_WINDOW_SIZE;
+        
+        if(samplesUntilHop == 0) {
+            analyseFrame();
+            samplesUntilHop = PITCH_HOP_SIZE;
+        }
+    }
+}
+
+/*
+ The chroma vector is what gets drawn when a mesh uses the pitch detector as its source
+ */
+int PitchDetector::getNumBins() const {
+    return CHROMA_BINS;
+}
+
+/*
+ Copies the newest chroma vector, C first
+ */
+int PitchDetector::readSpectrum(float *dest, int maxBins) {
+    results.fetch();
+    
+    const int numBins = jmin(maxBins, CHROMA_BINS);
+    FloatVectorOperations::copy(dest, results.getReadBuffer().chroma, numBins);
+    return numBins;
+}
+
+/*
+ Detected fundamental in Hz, 0 when the signal has no clear pitch
+ */
+float PitchDetector::getFundamental() const {
+    return fundamental.get();
+}
+
+/*
+ Height of the normalised square difference peak the fundamental was taken from (0 to 1)
+ */
+float PitchDetector::getClarity() const {
+    return clarity.get();
+}
+
+/*
+ Unrolls the history into a frame and publishes the pitch and chroma for it
+ */
+void PitchDetector::analyseFrame() {
+    const int tailSize = PITCH_WINDOW_SIZE - historyPosition;
+    FloatVectorOperations::copy(frame, history + historyPosition, tailSize);
+    FloatVectorOperations::copy(frame + tailSize, history, historyPosition);
+    
+    // One zero padded FFT of the frame feeds both the chroma and the autocorrelation
+    FloatVectorOperations::copy(correlation, frame, PITCH_WINDOW_SIZE);
+    FloatVectorOperations::clear(correlation + PITCH_WINDOW_SIZE, 3 * PITCH_WINDOW_SIZE);
+    correlationFFT->performRealOnlyForwardTransform(correlation, true);
+    
+    Result &result = results.getWriteBuffer();
+    foldChroma(result);
+    findPitch(result);
+    results.publish();
+    
+    fundamental = result.fundamental;
+    clarity = result.clarity;
+}
+
+/*
+ Adds each (re, im) pair of an interleaved array into one value
+ Written as a plain loop over unit strides so the compiler vectorises it, FloatVectorOperations has no deinterleave
+ */
+void PitchDetector::sumInterleavedPairs(float *dest, const float *source, int numPairs) {
+    for(int i = 0; i < numPairs; i++)
+        dest[i] = source[2 * i] + source[2 * i + 1];
+}
+
+/*
+ McLeod pitch method: the autocorrelation comes from the zero padded FFT and one inverse FFT,
+ the energy term of the difference function is a running sum so the whole frame is O(N log N)
+ Everything but that running sum works on whole arrays at a time
+ */
+void PitchDetector::findPitch(Result &result) {
+    const int N = PITCH_WINDOW_SIZE;
+    
+    // r(tau) = IFFT(|FFT(x)|^2), zero padded to 2N so the correlation does not wrap
+    FloatVectorOperations::multiply(correlation, correlation, 2 * N + 2);
+    for(int bin = 0; bin <= N; bin++) {
+        correlation[2 * bin] += correlation[2 * bin + 1];
+        correlation[2 * bin + 1] = 0.0f;
+    }
+    correlationFFT->performRealOnlyInverseTransform(correlation);
+    
+    const int minLag = jmax(2, (int) (sampleRate / PITCH_MAX_FREQUENCY));
+    const int maxLag = jmin(N / 2, (int) (sampleRate / PITCH_MIN_FREQUENCY) + 1);
+    
+    // m(tau) = sum of x[j]^2 + x[j + tau]^2 over the overlap, each lag drops one square from either end
+    FloatVectorOperations::multiply(squares, frame, frame, N);
+    
+    double runningEnergy = 2.0 * correlation[0];
+    for(int lag = 0; lag <= maxLag; lag++) {
+        if(lag > 0)
+            runningEnergy -= squares[lag - 1] + squares[N - lag];
+        energy[lag] = runningEnergy > 1.0e-9 ? (float) runningEnergy : std::numeric_limits<float>::max();
+    }
+    
+    // nsdf = 2 r / m, lags with no energy left divide by the largest float and end up as 0
+    // There is no vector divide in FloatVectorOperations, the plain loop below is vectorised by the compiler
+    FloatVectorOperations::multiply(nsdf, correlation, 2.0f, maxLag + 1);
+    for(int lag = 0; lag <= maxLag; lag++)
+        nsdf[lag] /= energy[lag];
+    
+    // Key maxima are the highest points between positive going and negative going zero crossings
+    int bestLag = -1;
+    float bestValue = 0.0f;
+    float highest = 0.0f;
+    int candidates[64];
+    int numCandidates = 0;
+    int lag = 1;
+    
+    while(lag < maxLag && nsdf[lag] > 0.0f)
+        lag++;
+    
+    while(lag < maxLag && numCandidates < 64) {
+        while(lag < maxLag && nsdf[lag] <= 0.0f)
+            lag++;
+        
+        int peak = lag;
+        while(lag < maxLag && nsdf[lag] > 0.0f) {
+            if(nsdf[lag] > nsdf[peak])
+                peak = lag;
+            lag++;
+        }
+        
+        if(peak < maxLag && peak >= minLag) {
+            candidates[numCandidates++] = peak;
+            highest = jmax(highest, nsdf[peak]);
+        }
+    }
+    
+    for(int i = 0; i < numCandidates; i++) {
+        if(nsdf[candidates[i]] >= PITCH_PEAK_THRESHOLD * highest) {
+            bestLag = candidates[i];
+            bestValue = nsdf[bestLag];
+            break;
+        }
+    }
+    
+    if(bestLag < 0 || bestValue < PITCH_MIN_CLARITY) {
+        result.fundamental = 0.0f;
+        result.clarity = bestValue;
+        return;
+    }
+    
+    // Parabolic interpolation around the chosen peak
+    const float left = nsdf[bestLag - 1];
+    const float centre = nsdf[bestLag];
+    const float right = nsdf[bestLag + 1];
+    const float denominator = left - 2.0f * centre + right;
+    float offset = 0.0f;
+    
+    if(denominator < 0.0f)
+        offset = jlimit(-0.5f, 0.5f, 0.5f * (left - right) / denominator);
+    
+    result.fundamental = (float) (sampleRate / (bestLag + offset));
+    result.clarity = jmin(1.0f, centre - 0.25f * (left - right) * offset);
+}
+
+/*
+ Folds the spectrum into the 12 pitch classes, normalised so the strongest class is 1
+ A Hann window is applied in the frequency domain on the zero padded spectrum, then only spectral
+ peaks are counted, at their interpolated frequency, so low notes do not smear into their neighbours
+ */
+void PitchDetector::foldChroma(Result &result) {
+    const int numBins = PITCH_WINDOW_SIZE;
+    
+    // The frame only fills half of the padded FFT, so the window's neighbours are two bins (four floats) away
+    const int numValues = 2 * (numBins - 3);
+    FloatVectorOperations::copyWithMultiply(windowed + 4, correlation + 4, 0.5f, numValues);
+    FloatVectorOperations::addWithMultiply(windowed + 4, correlation, -0.25f, numValues);
+    FloatVectorOperations::addWithMultiply(windowed + 4, correlation + 8, -0.25f, numValues);
+    FloatVectorOperations::multiply(windowed + 4, windowed + 4, numValues);
+    
+    // Peaks are picked on the power, the log interpolation below is the same for power and magnitude
+    sumInterleavedPairs(powers + 2, windowed + 4, numBins - 3);
+    
+    for(int i = 0; i < CHROMA_BINS; i++)
+        result.chroma[i] = 0.0f;
+    
+    const double binWidth = sampleRate / (2.0 * PITCH_WINDOW_SIZE);
+    const int firstBin = jmax(3, (int) (CHROMA_MIN_FREQUENCY / binWidth));
+    const int lastBin = jmin(numBins - 3, (int) (CHROMA_MAX_FREQUENCY / binWidth));
+    
+    for(int bin = firstBin; bin <= lastBin; bin++) {
+        const float centre = powers[bin];
+        
+        if(centre <= powers[bin - 1] || centre < powers[bin + 1] || centre <= 0.0f)
+            continue;
+        
+        const float left = std::log(powers[bin - 1] + 1.0e-24f);
+        const float right = std::log(powers[bin + 1] + 1.0e-24f);
+        const float middle = std::log(centre);
+        const float denominator = left - 2.0f * middle + right;
+        const float offset = denominator < 0.0f ? jlimit(-0.5f, 0.5f, 0.5f * (left - right) / denominator) : 0.0f;
+        
+        const double frequency = (bin + offset) * binWidth;
+        const int pitchClass = (roundToInt(12.0 * std::log2(frequency / 440.0)) + 9 + 12 * CHROMA_BINS) % CHROMA_BINS;
+        result.chroma[pitchClass] += centre;
+    }
+    
+    const float peak = FloatVectorOperations::findMaximum(result.chroma, CHROMA_BINS);
+    
+    if(peak > 0.0f)
+        FloatVectorOperations::multiply(result.chroma, 1.0f / peak, CHROMA_BINS);
+}
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    PitchDetector.h
+    Created: 19 Oct 2026 1:40:10pm
+    Author:  Esteban Cambronero
+    Analysis stage that tracks the fundamental (McLeod pitch method) and folds the spectrum into a chroma vector
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AnalysisStage.h"
+#include "SpectrumSource.h"
+#include "FFTPlanCache.h"
+#include "TripleBuffer.h"
+
+#define PITCH_WINDOW_ORDER 11
+#define PITCH_WINDOW_SIZE (1 << PITCH_WINDOW_ORDER)
+#define PITCH_HOP_SIZE 512
+#define PITCH_MIN_FREQUENCY 50.0
+#define PITCH_MAX_FREQUENCY 2000.0
+#define PITCH_PEAK_THRESHOLD 0.9f
+#define PITCH_MIN_CLARITY 0.5f
+#define CHROMA_BINS 12
+#define CHROMA_MIN_FREQUENCY 55.0
+#define CHROMA_MAX_FREQUENCY 4200.0
+
+class PitchDetector : public AnalysisStage, public SpectrumSource
+{
+public:
+    PitchDetector();
+    void prepare(double sampleRate, int numChannels, int maxBlockSize) override;
+    void process(const AudioBuffer<float> &block, int numSamples) override;
+    int getNumBins() const override;
+    int readSpectrum(float *dest, int maxBins) override;
+    float getFundamental() const;
+    float getClarity() const;
+private:
+    struct Result {
+        float chroma[CHROMA_BINS];
+        float fundamental;
+        float clarity;
+    };
+    void analyseFrame();
+    void foldChroma(Result &result);
+    void findPitch(Result &result);
+    static void sumInterleavedPairs(float *dest, const float *source, int numPairs);
+    
+    SharedResourcePointer<FFTPlanCache> fftPlans;
+    dsp::FFT *correlationFFT;
+    
+    double sampleRate;
+    int numChannels;
+    HeapBlock<float> history;
+    int historyPosition;
+    int samplesUntilHop;
+    
+    HeapBlock<float> frame;
+    HeapBlock<float> correlation;
+    HeapBlock<float> windowed;
+    HeapBlock<float> powers;
+    HeapBlock<float> squares;
+    HeapBlock<float> energy;
+    HeapBlock<float> nsdf;
+    
+    TripleBuffer<Result> results;
+    Atomic<float> fundamental;
+    Atomic<float> clarity;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PitchDetector)
+};
@@ -0,0 +1,482 @@
+/*
+  ==============================================================================
+
+    RenderHost.cpp
+    Created: 19 Oct 2026 8:52:17am
+    Author:  Esteban Cambronero
+    Owner of the single OpenGL context that every visualizer renders into as a pass
+  ==============================================================================
+*/
+
+#include "RenderHost.h"
+
+/*
+ Constructor for a render pass, the pass is not drawn until it is added to the host
+ */
+RenderPass::RenderPass(RenderHost &host) : renderHost(host), gLContext(host.getContext()) {
+    running = 0;
+}
+
+/*
+ Keeps the host repainting continuously for as long as this pass is running
+ */
+void RenderPass::start() {
+    running = 1;
+    renderHost.updateRepainting();
+}
+
+/*
+ Stops this pass from keeping the host repainting, it is still drawn whenever the host repaints while it is visible
+ */
+void RenderPass::stop() {
+    running = 0;
+    renderHost.updateRepainting();
+}
+
+bool RenderPass::isRunning() const {
+    return running.get() != 0;
+}
+
+/*
+ Constructor for the render host, attaches the one context every pass shares
+ */
+RenderHost::RenderHost() : framePacer(*this) {
+    neutralVAO = 0;
+    pacingMode = ANALYSIS_PACING;
+    frameRateCap = RENDER_HOST_DEFAULT_FRAME_RATE_CAP;
+    swapInterval = RENDER_HOST_DEFAULT_SWAP_INTERVAL;
+    transportRunning = 0;
+    anyPassRunning = 0;
+    appliedSwapInterval = -1;
+    nextFrameTime = 0.0;
+    pendingFrameTime = 0.0;
+    drawingOnScreen = 1;
+    contextReady = 0;
+    offscreenDepth = 0;
+    
+    context.setOpenGLVersionRequired(OpenGLContext::openGL3_2);
+    context.setRenderer(this);
+    context.attachTo(*this);
+    
+    setInterceptsMouseClicks(false, true);
+    startTimer(1000);
+    framePacer.startThread(8);
+}
+
+/*
+ Destructor for the render host, every pass should have been removed by now
+ */
+RenderHost::~RenderHost() {
+    jassert(passes.isEmpty());
+    
+    stopTimer();
+    framePacer.stopThread(1000);
+    context.setContinuousRepainting(false);
+    context.detach();
+}
+
+OpenGLContext &RenderHost::getContext() noexcept {
+    return context;
+}
+
+/*
+ Adds a visualizer to the passes drawn by the host as a hidden child, it is drawn once it is made visible
+ */
+void RenderHost::addPass(RenderPass *pass) {
+    addChildComponent(pass);
+    
+    const ScopedLock sl(passLock);
+    passes.add({ pass, false, Time::getMillisecondCounter() });
+}
+
+/*
+ Removes a visualizer from the host, releasing its GL objects on the render thread if it had any
+ Passes call this from their destructor, while their GL objects can still be deleted
+ */
+void RenderHost::removePass(RenderPass *pass) {
+    bool created = false;
+    
+    {
+        const ScopedLock sl(passLock);
+        
+        for(int i = 0; i < passes.size(); i++) {
+            if(passes.getReference(i).pass == pass) {
+                created = passes.getReference(i).created;
+                passes.remove(i);
+                break;
+            }
+        }
+    }
+    
+    if(created && context.isActive())
+        context.executeOnGLThread([pass] (OpenGLContext&) { pass->openGLContextClosing(); }, true);
+    
+    removeChildComponent(pass);
+    updateRepainting();
+}
+
+/*
+ Chooses between drawing as often as the swap interval allows and drawing only when frameAvailable() is called
+ */
+void RenderHost::setPacingMode(PacingMode mode) {
+    pacingMode = mode;
+    updateRepainting();
+}
+
+/*
+ Most frames per second drawn for new analysis, zero draws one for every call to frameAvailable()
+ It is only a ceiling, blocks of 1024 samples at 44.1 kHz come about 43 times a second, so a cap of 60 draws one frame per block
+ */
+void RenderHost::setFrameRateCap(int framesPerSecond) {
+    frameRateCap = jmax(0, framesPerSecond);
+}
+
+/*
+ Number of vertical blanks each frame waits for, zero draws without waiting
+ */
+void RenderHost::setSwapInterval(int numFramesPerSwap) {
+    swapInterval = jmax(0, numFramesPerSwap);
+    context.triggerRepaint();
+}
+
+/*
+ Nothing is drawn for new analysis or continuously while the transport is stopped, the last frame stays on screen
+ Resizing or interacting with a pass still draws it
+ */
+void RenderHost::setTransportRunning(bool isRunning) {
+    transportRunning = isRunning ? 1 : 0;
+    updateRepainting();
+}
+
+/*
+ Tells the host there is something new to draw, called from the analysis thread after every block
+ With the analysis pacing a frame is drawn if a pass is running, straight away if the frame rate cap allows it
+ and otherwise at the next beat of the cap, where it shows whatever analysis has arrived by then
+ */
+void RenderHost::frameAvailable() {
+    if(pacingMode.get() != ANALYSIS_PACING || transportRunning.get() == 0 || anyPassRunning.get() == 0)
+        return;
+    
+    const int cap = frameRateCap.get();
+    
+    if(cap == 0) {
+        context.triggerRepaint();
+        return;
+    }
+    
+    const ScopedLock sl(pacingLock);
+    
+    // A frame is already waiting for its beat
+    if(pendingFrameTime > 0.0)
+        return;
+    
+    const double now = Time::getMillisecondCounterHiRes();
+    
+    if(now < nextFrameTime) {
+        pendingFrameTime = nextFrameTime;
+        framePacer.notify();
+        return;
+    }
+    
+    drawPacedFrame(now, cap);
+}
+
+/*
+ Draws a capped frame and moves the beat on, frames follow each other at the cap's interval unless
+ the analysis fell behind by more than a frame. The pacing lock has to be held
+ */
+void RenderHost::drawPacedFrame(double now, int cap) {
+    const double frameInterval = 1000.0 / cap;
+    nextFrameTime = now - nextFrameTime < frameInterval ? nextFrameTime + frameInterval : now + frameInterval;
+    context.triggerRepaint();
+}
+
+/*
+ Time of the frame the pacer has to draw, zero when there is none
+ */
+double RenderHost::getPendingFrameTime() {
+    const ScopedLock sl(pacingLock);
+    return pendingFrameTime;
+}
+
+/*
+ Draws the frame the pacer was waiting for, unless the pacing has changed since
+ */
+void RenderHost::drawPendingFrame() {
+    const ScopedLock sl(pacingLock);
+    
+    const int cap = frameRateCap.get();
+    pendingFrameTime = 0.0;
+    
+    if(pacingMode.get() != ANALYSIS_PACING || transportRunning.get() == 0 || anyPassRunning.get() == 0 || cap == 0)
+        return;
+    
+    drawPacedFrame(jmax(Time::getMillisecondCounterHiRes(), nextFrameTime), cap);
+}
+
+/*
+ Waits for frameAvailable() to hand it a frame time, then sleeps until that time and draws it
+ */
+void RenderHost::FramePacer::run() {
+    while(! threadShouldExit()) {
+        const double due = host.getPendingFrameTime();
+        
+        if(due <= 0.0) {
+            wait(-1);
+            continue;
+        }
+        
+        const double delay = due - Time::getMillisecondCounterHiRes();
+        
+        if(delay > 0.0)
+            wait(jmax(1, (int) std::ceil(delay)));
+        else
+            host.drawPendingFrame();
+    }
+}
+
+/*
+ Time between frames the host aims for in milliseconds, the swap interval is taken to be of a 60 Hz display
+ Zero when frames are drawn as fast as they come
+ */
+double RenderHost::getFrameInterval() const {
+    if(pacingMode.get() == ANALYSIS_PACING && frameRateCap.get() > 0)
+        return 1000.0 / frameRateCap.get();
+    return swapInterval.get() * 1000.0 / 60.0;
+}
+
+/*
+ Whether repaints draw the passes into the host's window, offscreen frames are drawn either way
+ */
+void RenderHost::setDrawingOnScreen(bool shouldDraw) {
+    drawingOnScreen = shouldDraw ? 1 : 0;
+}
+
+/*
+ Draws every visible pass into an offscreen frame buffer the size of the host and copies it into the image, which is
+ resized to match. Returns false if the context or the frame buffer could not be made.
+ It waits for the render thread, so it can't be called from the render thread or the message thread
+ */
+bool RenderHost::renderOffscreen(Image &destination) {
+    jassert(! MessageManager::getInstance()->isThisTheMessageThread());
+    
+    if(! isContextReady())
+        return false;
+    
+    bool drawn = false;
+    context.executeOnGLThread([this, &destination, &drawn] (OpenGLContext&) { drawn = drawOffscreen(destination); }, true);
+    return drawn;
+}
+
+/*
+ Whether the context has been created on the render thread, it is only created once the host is showing in a window
+ */
+bool RenderHost::isContextReady() const {
+    return contextReady.get() != 0;
+}
+
+/*
+ Repaints continuously while any pass is running with the continuous pacing and the transport running,
+ otherwise only when a frame is available or the host is asked to repaint
+ */
+void RenderHost::updateRepainting() {
+    bool anyRunning = false;
+    
+    {
+        const ScopedLock sl(passLock);
+        for(const PassEntry &entry : passes)
+            anyRunning = anyRunning || entry.pass->isRunning();
+    }
+    
+    anyPassRunning = anyRunning ? 1 : 0;
+    context.setContinuousRepainting(anyRunning && transportRunning.get() != 0 && pacingMode.get() == CONTINUOUS_PACING);
+    context.triggerRepaint();
+}
+
+/*
+ Viewport of the pass being rendered in physical pixels of the host's framebuffer
+ Only meaningful from inside a pass's renderOpenGL()
+ */
+Rectangle<int> RenderHost::getPassViewport() const {
+    return passViewport;
+}
+
+/*
+ Creates the shared state, the passes create their own objects the first time they are drawn
+ */
+void RenderHost::newOpenGLContextCreated() {
+    context.extensions.glGenVertexArrays(1, &neutralVAO);
+    appliedSwapInterval = -1;
+    contextReady = 1;
+}
+
+/*
+ Lets every pass that was drawn release its GL objects before the context goes away
+ */
+void RenderHost::openGLContextClosing() {
+    contextReady = 0;
+    
+    const ScopedLock sl(passLock);
+    
+    for(PassEntry &entry : passes) {
+        if(entry.created)
+            entry.pass->openGLContextClosing();
+        entry.created = false;
+    }
+    
+    context.extensions.glDeleteVertexArrays(1, &neutralVAO);
+    neutralVAO = 0;
+    
+    if(offscreenDepth != 0)
+        context.extensions.glDeleteRenderbuffers(1, &offscreenDepth);
+    offscreenDepth = 0;
+    offscreenBuffer.release();
+}
+
+/*
+ Draws every visible pass into its own viewport of the window's framebuffer
+ */
+void RenderHost::renderOpenGL() {
+    // The swap interval can only be changed with the context active
+    if(swapInterval.get() != appliedSwapInterval) {
+        appliedSwapInterval = swapInterval.get();
+        context.setSwapInterval(appliedSwapInterval);
+    }
+    
+    if(drawingOnScreen.get() == 0)
+        return;
+    
+    const float scale = (float) context.getRenderingScale();
+    drawPasses(scale, roundToInt(scale * getWidth()), roundToInt(scale * getHeight()));
+}
+
+/*
+ Draws the passes into an offscreen frame buffer and reads it back into the image, top row first
+ */
+bool RenderHost::drawOffscreen(Image &destination) {
+    const float scale = (float) context.getRenderingScale();
+    const int width = roundToInt(scale * getWidth());
+    const int height = roundToInt(scale * getHeight());
+    
+    if(width <= 0 || height <= 0)
+        return false;
+    
+    if(offscreenBuffer.getWidth() != width || offscreenBuffer.getHeight() != height) {
+        if(! offscreenBuffer.initialise(context, width, height))
+            return false;
+        
+        // JUCE's frame buffers have no depth buffer, which the mesh's surface needs
+        if(offscreenDepth == 0)
+            context.extensions.glGenRenderbuffers(1, &offscreenDepth);
+        
+        offscreenBuffer.makeCurrentRenderingTarget();
+        context.extensions.glBindRenderbuffer(GL_RENDERBUFFER, offscreenDepth);
+        context.extensions.glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+        context.extensions.glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, offscreenDepth);
+        context.extensions.glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        offscreenBuffer.releaseAsRenderingTarget();
+    }
+    
+    if(! offscreenBuffer.makeCurrentRenderingTarget())
+        return false;
+    
+    drawPasses(scale, width, height);
+    
+    HeapBlock<PixelARGB> pixels((size_t) width * (size_t) height);
+    const bool read = offscreenBuffer.readPixels(pixels, Rectangle<int>(width, height));
+    offscreenBuffer.releaseAsRenderingTarget();
+    
+    if(! read)
+        return false;
+    
+    if(destination.getWidth() != width || destination.getHeight() != height || ! destination.isARGB())
+        destination = Image(Image::ARGB, width, height, false);
+    
+    // GL reads rows from the bottom up
+    const Image::BitmapData data(destination, Image::BitmapData::writeOnly);
+    for(int y = 0; y < height; y++)
+        memcpy(data.getLinePointer(y), pixels + (size_t) (height - 1 - y) * (size_t) width, sizeof(PixelARGB) * (size_t) width);
+    
+    return true;
+}
+
+/*
+ Draws every visible pass into its own viewport of the bound framebuffer
+ Each pass starts from a neutral vertex array, so state one pass leaves bound never ends up in another
+ */
+void RenderHost::drawPasses(float scale, int framebufferWidth, int framebufferHeight) {
+    glViewport(0, 0, framebufferWidth, framebufferHeight);
+    OpenGLHelpers::clear(getLookAndFeel().findColour(ResizableWindow::backgroundColourId));
+    glEnable(GL_SCISSOR_TEST);
+    
+    const ScopedLock sl(passLock);
+    const uint32 now = Time::getMillisecondCounter();
+    
+    for(PassEntry &entry : passes) {
+        RenderPass *pass = entry.pass;
+        if(! pass->isVisible() || pass->getWidth() <= 0 || pass->getHeight() <= 0) {
+            if(shouldRelease(entry, now)) {
+                pass->openGLContextClosing();
+                entry.created = false;
+            }
+            continue;
+        }
+        entry.lastShown = now;
+        
+        // GL counts rows from the bottom of the framebuffer
+        const Rectangle<int> area = (pass->getBounds().toFloat() * scale).getSmallestIntegerContainer();
+        passViewport = area.withY(framebufferHeight - area.getBottom());
+        glViewport(passViewport.getX(), passViewport.getY(), passViewport.getWidth(), passViewport.getHeight());
+        glScissor(passViewport.getX(), passViewport.getY(), passViewport.getWidth(), passViewport.getHeight());
+        context.extensions.glBindVertexArray(neutralVAO);
+        
+        if(! entry.created) {
+            pass->newOpenGLContextCreated();
+            entry.created = true;
+        }
+        pass->renderOpenGL();
+    }
+    
+    glDisable(GL_SCISSOR_TEST);
+    context.extensions.glBindVertexArray(neutralVAO);
+    context.extensions.glBindBuffer(GL_ARRAY_BUFFER, 0);
+    context.extensions.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+/*
+ Component function that needs to be overriden but since OpenGL is handling the graphics it is left empty
+ */
+void RenderHost::paint(Graphics&) {}
+
+/*
+ True for a hidden pass with GL objects that has been hidden past the timeout and is not one of the warm passes
+ */
+bool RenderHost::shouldRelease(const PassEntry &entry, uint32 now) const {
+    if(! entry.created || (int) (now - entry.lastShown) < RENDER_HOST_RELEASE_TIMEOUT)
+        return false;
+    
+    // Hidden passes shown more recently than this one take the warm places first
+    int newerPasses = 0;
+    for(const PassEntry &other : passes)
+        if(other.created && ! other.pass->isVisible() && other.lastShown > entry.lastShown)
+            newerPasses++;
+    
+    return newerPasses >= RENDER_HOST_WARM_PASSES;
+}
+
+/*
+ Releasing happens on the render thread, this makes sure it gets a frame to do it in even when nothing is animating
+ */
+void RenderHost::timerCallback() {
+    const uint32 now = Time::getMillisecondCounter();
+    bool anyToRelease = false;
+    
+    {
+        const ScopedLock sl(passLock);
+        for(const PassEntry &entry : passes)
+            anyToRelease = anyToRelease || (! entry.pass->isVisible() && shouldRelease(entry, now));
+    }
+    
+    if(anyToRelease)
+        context.triggerRepaint();
+}
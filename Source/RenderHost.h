@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+    RenderHost.h
+    Created: 19 Oct 2026 8:52:17am
+    Author:  Esteban Cambronero
+    Owner of the single OpenGL context that every visualizer renders into as a pass
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+
+// How long a pass has to stay hidden before its GL objects are deleted, and how many of the most recently
+// hidden passes keep them however long they stay hidden, so switching back never waits on shaders or buffers
+#define RENDER_HOST_RELEASE_TIMEOUT 30000
+#define RENDER_HOST_WARM_PASSES 1
+#define RENDER_HOST_DEFAULT_FRAME_RATE_CAP 60
+#define RENDER_HOST_DEFAULT_SWAP_INTERVAL 1
+
+// Calling convention for entry points loaded with OpenGLHelpers::getExtensionFunction,
+// windows.h and GL/gl.h define it but the macOS headers do not
+#ifndef APIENTRY
+ #define APIENTRY
+#endif
+
+class RenderHost;
+
+/*
+ A visualizer drawn by the render host, it keeps its own GL objects but has no context or render thread of its own
+ The OpenGLRenderer callbacks are made on the host's render thread with the viewport and scissor set to the pass
+ */
+class RenderPass : public Component, public OpenGLRenderer
+{
+public:
+    RenderPass(RenderHost &host);
+    void start();
+    void stop();
+    bool isRunning() const;
+protected:
+    RenderHost &renderHost;
+    OpenGLContext &gLContext;
+private:
+    Atomic<int> running;
+};
+
+class RenderHost : public Component, public OpenGLRenderer, private Timer
+{
+public:
+    enum PacingMode {
+        CONTINUOUS_PACING = 1,
+        ANALYSIS_PACING
+    };
+    RenderHost();
+    ~RenderHost();
+    OpenGLContext &getContext() noexcept;
+    void addPass(RenderPass *pass);
+    void removePass(RenderPass *pass);
+    void setPacingMode(PacingMode mode);
+    void setFrameRateCap(int framesPerSecond);
+    void setSwapInterval(int numFramesPerSwap);
+    void setTransportRunning(bool isRunning);
+    void frameAvailable();
+    double getFrameInterval() const;
+    void setDrawingOnScreen(bool shouldDraw);
+    bool renderOffscreen(Image &destination);
+    bool isContextReady() const;
+    void updateRepainting();
+    Rectangle<int> getPassViewport() const;
+    void newOpenGLContextCreated() override;
+    void openGLContextClosing() override;
+    void renderOpenGL() override;
+    void paint(Graphics &g) override;
+private:
+    // A pass only gets its GL objects the first time it is drawn, and gives them back once it has been hidden for a while
+    struct PassEntry {
+        RenderPass *pass;
+        bool created;
+        uint32 lastShown;
+    };
+    // Sleeps until the frame that analysis arrived too early for is due and draws it then, so that analysis still gets its frame
+    struct FramePacer : public Thread {
+        FramePacer(RenderHost &owner) : Thread("Frame Pacer"), host(owner) {}
+        void run() override;
+        RenderHost &host;
+    };
+    void drawPacedFrame(double now, int cap);
+    double getPendingFrameTime();
+    void drawPendingFrame();
+    void drawPasses(float scale, int framebufferWidth, int framebufferHeight);
+    bool drawOffscreen(Image &destination);
+    bool shouldRelease(const PassEntry &entry, uint32 now) const;
+    void timerCallback() override;
+    
+    OpenGLContext context;
+    GLuint neutralVAO;
+    
+    CriticalSection passLock;
+    Array<PassEntry> passes;
+    Rectangle<int> passViewport;
+    
+    // Frames are drawn continuously or when the analysis has something new, and not at all while the transport is stopped
+    // nextFrameTime keeps capped frames on a steady beat, analysis that arrives before it is drawn by the pacer at that time
+    // pendingFrameTime is the frame the pacer is waiting for, zero when there is none
+    Atomic<int> pacingMode;
+    Atomic<int> frameRateCap;
+    Atomic<int> swapInterval;
+    Atomic<int> transportRunning;
+    Atomic<int> anyPassRunning;
+    int appliedSwapInterval;
+    CriticalSection pacingLock;
+    double nextFrameTime;
+    double pendingFrameTime;
+    FramePacer framePacer;
+    
+    // Offscreen frames are drawn into their own frame buffer with a depth buffer attached, for rendering without a display
+    Atomic<int> drawingOnScreen;
+    Atomic<int> contextReady;
+    OpenGLFrameBuffer offscreenBuffer;
+    GLuint offscreenDepth;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderHost)
+};
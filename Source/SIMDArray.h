@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    SIMDArray.h
+    Created: 19 Oct 2026 10:31:05am
+    Author:  Esteban Cambronero
+    Fixed size, SIMD aligned array of dsp::SIMDRegister values
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+
+template <typename ElementType>
+class SIMDArray
+{
+public:
+    typedef dsp::SIMDRegister<ElementType> Vec;
+    
+    SIMDArray() : data(nullptr), numElements(0) {}
+    
+    /*
+     Reallocates the array to hold newSize registers, all cleared to zero
+     */
+    void allocate(int newSize) {
+        numElements = newSize;
+        memory.allocate((size_t) newSize * sizeof(Vec) + Vec::SIMDRegisterSize, true);
+        data = reinterpret_cast<Vec*> (Vec::getNextSIMDAlignedPtr(reinterpret_cast<ElementType*> (memory.getData())));
+    }
+    
+    void clear() {
+        if(data != nullptr)
+            zeromem(data, (size_t) numElements * sizeof(Vec));
+    }
+    
+    int size() const noexcept                   { return numElements; }
+    Vec* getData() noexcept                     { return data; }
+    Vec& operator[](int index) noexcept         { return data[index]; }
+    const Vec& operator[](int index) const noexcept   { return data[index]; }
+    
+    /*
+     Gives access to the individual scalar lanes of the array
+     */
+    ElementType* getRawData() noexcept          { return reinterpret_cast<ElementType*> (data); }
+    
+private:
+    HeapBlock<char> memory;
+    Vec *data;
+    int numElements;
+    
+    JUCE_DECLARE_NON_COPYABLE(SIMDArray)
+};
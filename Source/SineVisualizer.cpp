@@ -10,128 +10,337 @@
 
 #include "SineVisualizer.h"
 
+#ifndef GL_TEXTURE_BUFFER
+ #define GL_TEXTURE_BUFFER 0x8C2A
+#endif
+#ifndef GL_R32F
+ #define GL_R32F 0x822E
+#endif
+#ifndef GL_RG32F
+ #define GL_RG32F 0x8230
+#endif
+
 /*
- Constructor for sine visualizer
+ Constructor for sine visualizer, it adds itself to the render host as a hidden pass
  */
-SineVisualizer::SineVisualizer(CircularBuffer *cBuffer) : readBuffer(2, CIRC_BUFFER_READ_SIZE){
-    gLContext.setOpenGLVersionRequired(OpenGLContext::OpenGLVersion::openGL3_2);
+SineVisualizer::SineVisualizer(RenderHost &host, CircularBuffer *cBuffer) : RenderPass(host), readBuffer(2, SINE_STREAM_BLOCK_SIZE){
     circBuffer = cBuffer;
-    gLContext.setRenderer(this);
-    gLContext.attachTo(*this);
+    readPosition = circBuffer->getWritePosition();
+    requestedWindowLength = SINE_DEFAULT_WINDOW_LENGTH;
+    windowLength = 0;
+    ringWrite = 0;
+    overlayShown = false;
+    monoBuffer.allocate(SINE_STREAM_BLOCK_SIZE, true);
     
     addAndMakeVisible(statusLabel);
     statusLabel.setJustificationType(Justification::topLeft);
     statusLabel.setFont(Font(14.0f));
+    statusLabel.setInterceptsMouseClicks(false, false);
+    
+    renderHost.addPass(this);
 }
 
 /*
  Destructor for Sine Visualizer
  */
 SineVisualizer::~SineVisualizer() {
-    gLContext.setContinuousRepainting(false);
-    gLContext.detach();
+    renderHost.removePass(this);
     
     circBuffer = nullptr;
 }
 
 /*
- Function that starts the animation of the visualizer
+ Sets how many of the newest samples are shown across the view, the window starts again from silence
  */
-void SineVisualizer::start() {
-    gLContext.setContinuousRepainting(true);
+void SineVisualizer::setWindowLength(int numSamples) {
+    requestedWindowLength = jlimit(2, SINE_MAX_WINDOW_LENGTH, numSamples);
 }
 
 /*
- Function that stops the animation of the visualizer
+ Shows the frame timings, the analysis load and the ring's fill level under the shader's status, a few times a second
+ Nothing is measured while it is hidden
  */
-void SineVisualizer::stop() {
-    gLContext.setContinuousRepainting(false);
+void SineVisualizer::setPerformanceOverlay(bool shouldShow) {
+    overlayShown = shouldShow;
+    frameStats.setEnabled(shouldShow);
+    
+    if (! shouldShow)
+        statusLabel.setText(shaderStatus, dontSendNotification);
 }
 
 /*
- Initializes the graphics for OpenGL
+ Initializes the graphics in the host's context the first time the visualizer is drawn
  */
 void SineVisualizer::newOpenGLContextCreated() {
+    VAO = 0;
+    
+    // Core since OpenGL 3.1, but not in JUCE's extension functions
+    // The samples only live in buffer textures, so without it the visualizer says why in its status and draws nothing
+    texBuffer = (TexBufferFunction) OpenGLHelpers::getExtensionFunction("glTexBuffer");
+    
+    if (texBuffer == nullptr)
+    {
+        postStatus("OpenGL: glTexBuffer is not available, the waveform needs buffer textures", false);
+        return;
+    }
+    
     createShaders();
     
-    gLContext.extensions.glGenBuffers(1, &VBO);
-    gLContext.extensions.glGenBuffers(1, &EBO);
+    // The vertices have no attributes, the vertex array only has to exist so nothing else's state is used
+    gLContext.extensions.glGenVertexArrays(1, &VAO);
+    gLContext.extensions.glGenBuffers(1, &sampleBuffer);
+    gLContext.extensions.glGenBuffers(1, &summaryBuffer);
+    glGenTextures(1, &sampleTexture);
+    glGenTextures(1, &summaryTexture);
+    gpuTimer.create();
+    
+    shownColumns = 0;
+    shownHeight = 0;
+    windowLength = 0;
+    updateSampleBuffer(requestedWindowLength.get());
 }
 
 /*
-Deallocates memory when openGL context is closed
+Deallocates memory when the visualizer leaves the host or the host's context is closed
 */
 void SineVisualizer::openGLContextClosing() {
-    shader->release();
+    if (shader != nullptr)
+        shader->release();
+    
     shader = nullptr;
     uniforms = nullptr;
+    
+    if (VAO != 0)
+    {
+        glDeleteTextures(1, &sampleTexture);
+        glDeleteTextures(1, &summaryTexture);
+        gLContext.extensions.glDeleteBuffers(1, &sampleBuffer);
+        gLContext.extensions.glDeleteBuffers(1, &summaryBuffer);
+        gLContext.extensions.glDeleteVertexArrays(1, &VAO);
+        gpuTimer.release();
+    }
+    
+    VAO = 0;
+    windowLength = 0;
 }
 
 /*
 Renders the continiously updated graphics from the FFT data
+Everything that does not change from frame to frame is set up once, so a frame is the new samples, the ring's start and one draw
 */
 void SineVisualizer::renderOpenGL() {
+    // Set up failed or the shaders did not compile, the status label already says why
+    if (shader == nullptr || VAO == 0)
+    {
+        OpenGLHelpers::clear(getLookAndFeel().findColour(ResizableWindow::backgroundColourId));
+        return;
+    }
+    
+    const bool measuring = frameStats.beginFrame(renderHost.getFrameInterval());
+    if (measuring)
+        gpuTimer.begin();
+    
+    // The host has already set the viewport and scissor to the visualizer
     float scale = (float) gLContext.getRenderingScale();
-    glViewport(0, 0, roundToInt(scale * getWidth()), roundToInt(scale * getHeight()));
+    const int columns = jmax(1, roundToInt(scale * getWidth()));
+    const int height = jmax(1, roundToInt(scale * getHeight()));
     
     OpenGLHelpers::clear(getLookAndFeel().findColour(ResizableWindow::backgroundColourId));
     
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    
     shader->use();
     
-    if (uniforms->resolution != nullptr)
-            uniforms->resolution->set ((GLfloat) scale * getWidth(), (GLfloat) scale * getHeight());
+    if (requestedWindowLength.get() != windowLength)
+        updateSampleBuffer(requestedWindowLength.get());
+    
+    if (columns != shownColumns || height != shownHeight)
+    {
+        shownColumns = columns;
+        shownHeight = height;
         
-        if (uniforms->sampleData != nullptr)
-        {
-            circBuffer->read (readBuffer, CIRC_BUFFER_READ_SIZE);
-            
-            FloatVectorOperations::clear (visualizationBuffer, CIRC_BUFFER_READ_SIZE);
-            
-            for (int i = 0; i < 2; ++i)
-            {
-                FloatVectorOperations::add (visualizationBuffer, readBuffer.getReadPointer(i, 0), CIRC_BUFFER_READ_SIZE);
-            }
-            
-            uniforms->sampleData->set (visualizationBuffer, 256);
-        }
+        if (uniforms->numColumns != nullptr)
+            uniforms->numColumns->set((GLint) columns);
         
-        // Define Vertices for a Square (the view plane)
-        GLfloat vertices[] = {
-            1.0f,   1.0f,  0.0f,  // Top Right
-            1.0f,  -1.0f,  0.0f,  // Bottom Right
-            -1.0f, -1.0f,  0.0f,  // Bottom Left
-            -1.0f,  1.0f,  0.0f   // Top Left
-        };
-        // Define Which Vertex Indexes Make the Square
-        GLuint indices[] = {
-            0, 1, 3,
-            1, 2, 3
-        };
-    
-    gLContext.extensions.glBindBuffer (GL_ARRAY_BUFFER, VBO);
-    gLContext.extensions.glBufferData (GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STREAM_DRAW);
+        // Half the line's thickness in clip space, a pixel and a half either side of the wave
+        if (uniforms->thickness != nullptr)
+            uniforms->thickness->set(3.0f / (float) height);
+    }
+    
+    streamSamples();
+    
+    frameStats.beginStage();
+    
+    if (uniforms->ringStart != nullptr)
+        uniforms->ringStart->set((GLint) ringWrite);
+    
+    gLContext.extensions.glBindVertexArray(VAO);
+    gLContext.extensions.glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_BUFFER, summaryTexture);
+    gLContext.extensions.glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, sampleTexture);
+    
+    // Two vertices per column, at the lowest and highest sample, make the wave's outline as one strip
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 2 * columns);
+    
+    frameStats.endStage(FrameStats::DRAW_STAGE);
+    
+    if (measuring)
+    {
+        gpuTimer.end();
+        if (frameStats.endFrame(gpuTimer))
+            postStatus(frameStats.takeReport(), true);
+    }
+}
 
-        
-    // EBO (Element Buffer Object) - Bind and Write to Buffer
-    gLContext.extensions.glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, EBO);
-    gLContext.extensions.glBufferData (GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STREAM_DRAW);
+/*
+ Reallocates the ring of samples for a new window length, every sample starts at silence
+ The shader has to be in use, as the window length is set in it here
+ */
+void SineVisualizer::updateSampleBuffer(int length) {
+    windowLength = length;
+    ringWrite = 0;
+    
+    // Every level halves the one below it, rounding up, until a single node covers the whole ring
+    summaryOffsets.clearQuick();
+    summarySizes.clearQuick();
+    summaryOffsets.add(0);
+    summarySizes.add(windowLength);
+    
+    int numNodes = 0;
+    while (summarySizes.getLast() > 1)
+    {
+        summaryOffsets.add(numNodes);
+        summarySizes.add((summarySizes.getLast() + 1) / 2);
+        numNodes += summarySizes.getLast();
+    }
+    
+    ringSamples.allocate(windowLength, true);
+    summary.allocate(2 * numNodes, true);
+    
+    gLContext.extensions.glBindBuffer(GL_TEXTURE_BUFFER, sampleBuffer);
+    gLContext.extensions.glBufferData(GL_TEXTURE_BUFFER, sizeof(GLfloat) * windowLength, ringSamples, GL_STREAM_DRAW);
+    gLContext.extensions.glBindBuffer(GL_TEXTURE_BUFFER, summaryBuffer);
+    gLContext.extensions.glBufferData(GL_TEXTURE_BUFFER, sizeof(GLfloat) * 2 * numNodes, summary, GL_STREAM_DRAW);
+    
+    glBindTexture(GL_TEXTURE_BUFFER, sampleTexture);
+    texBuffer(GL_TEXTURE_BUFFER, GL_R32F, sampleBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, summaryTexture);
+    texBuffer(GL_TEXTURE_BUFFER, GL_RG32F, summaryBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    
+    if (uniforms->windowLength != nullptr)
+        uniforms->windowLength->set((GLint) windowLength);
+}
 
+/*
+ Reads everything written to the circular buffer since the last frame, sums the channels and adds it to the ring
+ */
+void SineVisualizer::streamSamples() {
+    const int channels = jmin(2, circBuffer->getNumChannels());
+    int numRead;
+    
+    frameStats.beginStage();
+    
+    while ((numRead = circBuffer->readFrom(readBuffer, readPosition, SINE_STREAM_BLOCK_SIZE)) > 0)
+    {
+        FloatVectorOperations::copy(monoBuffer, readBuffer.getReadPointer(0), numRead);
+        for (int i = 1; i < channels; ++i)
+            FloatVectorOperations::add(monoBuffer, readBuffer.getReadPointer(i), numRead);
         
-    // Setup Vertex Attributes
-    gLContext.extensions.glVertexAttribPointer (0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
-    gLContext.extensions.glEnableVertexAttribArray (0);
+        frameStats.endStage(FrameStats::RING_READ_STAGE);
+        frameStats.beginStage();
+        uploadSamples(monoBuffer, numRead);
+        frameStats.endStage(FrameStats::UPLOAD_STAGE);
+        frameStats.beginStage();
+    }
     
-    // Draw Vertices
-    glDrawElements (GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0); // For EBO's (Element Buffer Objects) (Indices)
+    frameStats.endStage(FrameStats::RING_READ_STAGE);
+}
+
+/*
+ Shows text in the status label from the render thread, either the shader's status or a performance report to go under it
+ Reports that arrive after the overlay has been hidden are dropped
+ */
+void SineVisualizer::postStatus(const String &text, bool isReport) {
+    Component::SafePointer<SineVisualizer> visualizer(this);
+    MessageManager::callAsync([visualizer, text, isReport] {
+        SineVisualizer *target = visualizer.getComponent();
         
+        if (target == nullptr || (isReport && ! target->overlayShown))
+            return;
+        
+        if (! isReport)
+            target->shaderStatus = text;
+        
+        target->statusLabel.setText(isReport ? target->shaderStatus + "\n" + text : text, dontSendNotification);
+    });
+}
+
+/*
+ Writes samples into the ring after the newest ones, if there are more than the window holds only the last are kept
+ The summary nodes over the written samples are rebuilt and uploaded with them
+ */
+void SineVisualizer::uploadSamples(const GLfloat *samples, int numSamples) {
+    if (numSamples > windowLength)
+    {
+        samples += numSamples - windowLength;
+        numSamples = windowLength;
+    }
+    
+    const int beforeWrap = jmin(numSamples, windowLength - ringWrite);
+    FloatVectorOperations::copy(ringSamples + ringWrite, samples, beforeWrap);
+    FloatVectorOperations::copy(ringSamples, samples + beforeWrap, numSamples - beforeWrap);
+    
+    gLContext.extensions.glBindBuffer(GL_TEXTURE_BUFFER, sampleBuffer);
+    gLContext.extensions.glBufferSubData(GL_TEXTURE_BUFFER, sizeof(GLfloat) * ringWrite, sizeof(GLfloat) * beforeWrap, samples);
+    if (numSamples > beforeWrap)
+        gLContext.extensions.glBufferSubData(GL_TEXTURE_BUFFER, 0, sizeof(GLfloat) * (numSamples - beforeWrap), samples + beforeWrap);
     
+    updateSummary(ringWrite, ringWrite + beforeWrap);
+    if (numSamples > beforeWrap)
+        updateSummary(0, numSamples - beforeWrap);
+    
+    ringWrite = (ringWrite + numSamples) % windowLength;
+}
+
+/*
+ Rebuilds the nodes of every level over the samples from start up to end in storage order, then uploads each level's changed nodes
+ The last node of a level may only have one node below it
+ */
+void SineVisualizer::updateSummary(int start, int end) {
+    int first = start;
+    int last = end - 1;
+    
+    gLContext.extensions.glBindBuffer(GL_TEXTURE_BUFFER, summaryBuffer);
+    
+    for (int level = 1; level < summarySizes.size(); ++level)
+    {
+        first >>= 1;
+        last >>= 1;
+        
+        const int lastBelow = summarySizes[level - 1] - 1;
+        const GLfloat *below = summary + 2 * summaryOffsets[level - 1];
+        GLfloat *nodes = summary + 2 * summaryOffsets[level];
         
-    // Reset the element buffers so child Components draw correctly
-    gLContext.extensions.glBindBuffer (GL_ARRAY_BUFFER, 0);
-    gLContext.extensions.glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, 0);
+        for (int i = first; i <= last; ++i)
+        {
+            const int left = 2 * i;
+            const int right = jmin(2 * i + 1, lastBelow);
+            
+            if (level == 1)
+            {
+                nodes[2 * i] = jmin(ringSamples[left], ringSamples[right]);
+                nodes[2 * i + 1] = jmax(ringSamples[left], ringSamples[right]);
+            }
+            else
+            {
+                nodes[2 * i] = jmin(below[2 * left], below[2 * right]);
+                nodes[2 * i + 1] = jmax(below[2 * left + 1], below[2 * right + 1]);
+            }
+        }
+        
+        gLContext.extensions.glBufferSubData(GL_TEXTURE_BUFFER, sizeof(GLfloat) * 2 * (summaryOffsets[level] + first),
+                                             sizeof(GLfloat) * 2 * (last - first + 1), nodes + 2 * first);
+    }
 }
 
 
@@ -140,45 +349,103 @@ void SineVisualizer::renderOpenGL() {
  */
 void SineVisualizer::createShaders() {
         VERTEX_SHADER =
-        "attribute vec3 position;\n"
+        "#version 330 core\n"
+        "uniform samplerBuffer samples;\n"
+        "uniform samplerBuffer summary;\n"
+        "uniform int windowLength;\n"
+        "uniform int ringStart;\n"
+        "uniform int numColumns;\n"
+        "uniform float thickness;\n"
         "\n"
-        "void main()\n"
+        // Samples are counted from the oldest one in the window, which is where the next one will be written
+        "float sampleAt (int index)\n"
         "{\n"
-        "    gl_Position = vec4(position, 1.0);\n"
-        "}\n";
-        
-        FRAGMENT_SHADER =
-        "uniform vec2  resolution;\n"
-        "uniform float audioSampleData[256];\n"
+        "    return texelFetch (samples, (ringStart + index) % windowLength).r;\n"
+        "}\n"
         "\n"
-        "void getAmplitudeForXPos (in float xPos, out float audioAmplitude)\n"
+        // Node of the pyramid, level 0 is the samples themselves and offset is where the level starts in the summary
+        "float nodeAt (int level, int offset, int index, int component)\n"
         "{\n"
-        // Buffer size - 1
-        "   float perfectSamplePosition = 255.0 * xPos / resolution.x;\n"
-        "   int leftSampleIndex = int (floor (perfectSamplePosition));\n"
-        "   int rightSampleIndex = int (ceil (perfectSamplePosition));\n"
-        "   audioAmplitude = mix (audioSampleData[leftSampleIndex], audioSampleData[rightSampleIndex], fract (perfectSamplePosition));\n"
+        "    return level == 0 ? texelFetch (samples, index).r : texelFetch (summary, offset + index)[component];\n"
+        "}\n"
+        "\n"
+        // Lowest (component 0) or highest (component 1) sample from lo up to hi in storage order. As in a bottom up segment tree,
+        // an odd node at either end is taken on its own and the rest move up a level, so at most two nodes are read per level
+        "float extremeIn (int lo, int hi, int component)\n"
+        "{\n"
+        "    float extreme = component == 0 ? 3.4e38 : -3.4e38;\n"
+        "    int offset = 0;\n"
+        "    for (int level = 0; lo < hi; ++level)\n"
+        "    {\n"
+        "        if ((lo & 1) == 1)\n"
+        "        {\n"
+        "            float node = nodeAt (level, offset, lo, component);\n"
+        "            extreme = component == 0 ? min(extreme, node) : max(extreme, node);\n"
+        "            lo++;\n"
+        "        }\n"
+        "        if ((hi & 1) == 1)\n"
+        "        {\n"
+        "            hi--;\n"
+        "            float node = nodeAt (level, offset, hi, component);\n"
+        "            extreme = component == 0 ? min(extreme, node) : max(extreme, node);\n"
+        "        }\n"
+        "        if (level > 0)\n"
+        "            offset += (windowLength + (1 << level) - 1) >> level;\n"
+        "        lo >>= 1;\n"
+        "        hi >>= 1;\n"
+        "    }\n"
+        "    return extreme;\n"
         "}\n"
         "\n"
-        "#define THICKNESS 0.02\n"
         "void main()\n"
         "{\n"
-        "    float y = gl_FragCoord.y / resolution.y;\n"
-        "    float amplitude = 0.0;\n"
-        "    getAmplitudeForXPos (gl_FragCoord.x, amplitude);\n"
+        // The first vertex of each column is at its highest sample and the second at its lowest, so each finds only its own
+        "    int column = gl_VertexID / 2;\n"
+        "    int component = (gl_VertexID % 2) == 0 ? 1 : 0;\n"
+        "    float first = float(column) * float(windowLength) / float(numColumns);\n"
+        "    float last = float(column + 1) * float(windowLength) / float(numColumns);\n"
+        "    float extreme;\n"
+        // With fewer samples than columns the wave is interpolated between the two nearest samples
+        "    if (last - first <= 1.0)\n"
+        "    {\n"
+        "        float position = float(column) * float(windowLength - 1) / float(max(numColumns - 1, 1));\n"
+        "        int left = int(floor(position));\n"
+        "        extreme = mix (sampleAt (left), sampleAt (min(left + 1, windowLength - 1)), fract(position));\n"
+        "    }\n"
+        // Otherwise the column covers its samples and the first of the next column, so neighbouring columns join up.
+        // In storage order that range wraps at most once, at the end of the ring
+        "    else\n"
+        "    {\n"
+        "        int start = int(first);\n"
+        "        int count = min(int(last) + 1, windowLength) - start;\n"
+        "        int lo = (ringStart + start) % windowLength;\n"
+        "        extreme = extremeIn (lo, min(lo + count, windowLength), component);\n"
+        "        if (lo + count > windowLength)\n"
+        "        {\n"
+        "            float wrapped = extremeIn (0, lo + count - windowLength, component);\n"
+        "            extreme = component == 0 ? min(extreme, wrapped) : max(extreme, wrapped);\n"
+        "        }\n"
+        "    }\n"
         "\n"
         // Centers & Reduces Wave Amplitude
-        "    amplitude = 0.5 - amplitude / 2.5;\n"
-        "    float r = abs (THICKNESS / (amplitude-y));\n"
-        "\n"
-        "gl_FragColor = vec4 (r - abs (r * 0.2), r - abs (r * 0.2), r - abs (r * 0.2), 1.0);\n"
+        "    float y = component == 1 ? -extreme / 1.25 - thickness : -extreme / 1.25 + thickness;\n"
+        "    float x = (float(column) + 0.5) / float(numColumns) * 2.0 - 1.0;\n"
+        "    gl_Position = vec4(x, y, 0.0, 1.0);\n"
+        "}\n";
+        
+        FRAGMENT_SHADER =
+        "#version 330 core\n"
+        "out vec4 color;\n"
+        "void main()\n"
+        "{\n"
+        "    color = vec4 (0.8, 0.8, 0.8, 1.0);\n"
         "}\n";
         
         ScopedPointer<OpenGLShaderProgram> newShader (new OpenGLShaderProgram (gLContext));
         String statusText;
         
-        if (newShader->addVertexShader (OpenGLHelpers::translateVertexShaderToV3 (VERTEX_SHADER))
-            && newShader->addFragmentShader (OpenGLHelpers::translateFragmentShaderToV3 (FRAGMENT_SHADER))
+        if (newShader->addVertexShader (VERTEX_SHADER)
+            && newShader->addFragmentShader (FRAGMENT_SHADER)
             && newShader->link())
         {
             uniforms = nullptr;
@@ -188,12 +455,20 @@ void SineVisualizer::createShaders() {
             
             uniforms   = new Uniforms (gLContext, *shader);
             
+            // The samples are always read from the first texture unit and their summary from the second
+            if (uniforms->samples != nullptr)
+                uniforms->samples->set ((GLint) 0);
+            if (uniforms->summary != nullptr)
+                uniforms->summary->set ((GLint) 1);
+            
             statusText = "GLSL: v" + String (OpenGLShaderProgram::getLanguageVersion(), 2);
         }
         else
         {
             statusText = newShader->getLastError();
         }
+        
+        postStatus(statusText, false);
 }
 
 /*
@@ -208,7 +483,7 @@ OpenGLShaderProgram::Uniform* SineVisualizer::Uniforms::createUniform(OpenGLCont
 Resizes the circular mesh as an overriden function from component
 */
 void SineVisualizer::resized() {
-    statusLabel.setBounds(getLocalBounds().reduced(4).removeFromTop(75));
+    statusLabel.setBounds(getLocalBounds().reduced(4).removeFromTop(100));
 }
 /*
 Component function that needs to be overriden but since OpenGL is handling the graphics it is left empty
@@ -219,6 +494,10 @@ void SineVisualizer::paint(Graphics &g) {};
 Constructor to create the uniforms for the visualizer
 */
 SineVisualizer::Uniforms::Uniforms(OpenGLContext &openContext, OpenGLShaderProgram &shader) {
-    resolution = createUniform(openContext, shader, "resolution");
-    sampleData = createUniform(openContext, shader, "audioSampleData");
+    samples = createUniform(openContext, shader, "samples");
+    summary = createUniform(openContext, shader, "summary");
+    windowLength = createUniform(openContext, shader, "windowLength");
+    ringStart = createUniform(openContext, shader, "ringStart");
+    numColumns = createUniform(openContext, shader, "numColumns");
+    thickness = createUniform(openContext, shader, "thickness");
 }
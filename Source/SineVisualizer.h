@@ -11,18 +11,22 @@
 #pragma once
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "CircularBuffer.h"
+#include "RenderHost.h"
+#include "FrameStats.h"
 
-#define CIRC_BUFFER_READ_SIZE 256
+#define SINE_DEFAULT_WINDOW_LENGTH 256
+#define SINE_MAX_WINDOW_LENGTH (1 << 20)
+#define SINE_STREAM_BLOCK_SIZE 4096
 
-class SineVisualizer : public Component, public OpenGLRenderer
+class SineVisualizer : public RenderPass
 
 {
 public:
-    SineVisualizer(CircularBuffer *circBuffer);
+    SineVisualizer(RenderHost &host, CircularBuffer *circBuffer);
     ~SineVisualizer();
     
-    void start();
-    void stop();
+    void setWindowLength(int numSamples);
+    void setPerformanceOverlay(bool shouldShow);
     
     void newOpenGLContextCreated() override;
     void openGLContextClosing() override;
@@ -31,14 +35,40 @@ public:
     void resized() override;
 private:
     void createShaders();
+    void updateSampleBuffer(int length);
+    void streamSamples();
+    void uploadSamples(const GLfloat *samples, int numSamples);
+    void updateSummary(int start, int end);
+    void postStatus(const String &text, bool isReport);
     struct Uniforms {
         Uniforms(OpenGLContext &openGLContext, OpenGLShaderProgram &shaderProgram);
-        ScopedPointer<OpenGLShaderProgram::Uniform> resolution, sampleData;
+        ScopedPointer<OpenGLShaderProgram::Uniform> samples, summary, windowLength, ringStart, numColumns, thickness;
     private:
     static OpenGLShaderProgram::Uniform *createUniform (OpenGLContext &openGL, OpenGLShaderProgram &shader, const char *uniformName);
     };
-    OpenGLContext gLContext;
-    GLuint VBO, VAO, EBO;
+    GLuint VAO;
+    
+    // The newest windowLength samples are kept in a ring in a buffer texture, ringWrite is where the next one goes
+    GLuint sampleBuffer, sampleTexture;
+    typedef void (APIENTRY *TexBufferFunction) (GLenum, GLenum, GLuint);
+    TexBufferFunction texBuffer;
+    
+    // A min/max pyramid over the ring's storage order in a second buffer texture, level k has one (min, max) node for
+    // every 2^k samples and level 0 is the samples themselves. Each column covers its part of the window with the
+    // fewest whole nodes, so the cost follows the width and only grows with the log of the window length.
+    // The levels are kept here as well, so the nodes over newly written samples can be rebuilt and uploaded
+    GLuint summaryBuffer, summaryTexture;
+    HeapBlock<GLfloat> ringSamples;
+    HeapBlock<GLfloat> summary;
+    Array<int> summaryOffsets;
+    Array<int> summarySizes;
+    Atomic<int> requestedWindowLength;
+    int windowLength;
+    int ringWrite;
+    
+    // Uniforms that only change with the window length or the view's size are only set when they do
+    int shownColumns;
+    int shownHeight;
     
     ScopedPointer<OpenGLShaderProgram> shader;
     ScopedPointer<Uniforms> uniforms;
@@ -47,9 +77,17 @@ private:
     const char *FRAGMENT_SHADER;
     
     CircularBuffer *circBuffer;
+    int readPosition;
     AudioBuffer<GLfloat> readBuffer;
+    HeapBlock<GLfloat> monoBuffer;
+    
+    // The status label shows the shader's status, with the performance overlay under it while that is shown
+    // The GPU timer is only run for the overlay
+    FrameStats frameStats;
+    GpuTimer gpuTimer;
+    String shaderStatus;
+    bool overlayShown;
     Label statusLabel;
-    GLfloat visualizationBuffer[CIRC_BUFFER_READ_SIZE];
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SineVisualizer)
 };
@@ -0,0 +1,247 @@
+/*
+  ==============================================================================
+
+    SlidingDFT.cpp
+    Created: 19 Oct 2026 7:58:37am
+    Author:  Esteban Cambronero
+    Analysis stage that updates a set of DFT bins sample by sample for a spectrum on every block
+  ==============================================================================
+*/
+
+#include "SlidingDFT.h"
+
+/*
+ Constructor for the sliding DFT, nothing is tracked until the stage is prepared
+ */
+SlidingDFT::SlidingDFT() {
+    sampleRate = 44100.0;
+    numChannels = 0;
+    position = 0;
+    numBins = 0;
+    numTracked = 0;
+    numGroups = 0;
+    publishedBins = 0;
+}
+
+/*
+ Allocates the buffers, picks the bins for the sample rate and starts from an empty window
+ */
+void SlidingDFT::prepare(double rate, int channels, int maxBlockSize) {
+    sampleRate = rate;
+    numChannels = channels;
+    mono.allocate(maxBlockSize, true);
+    difference.allocate(maxBlockSize, true);
+    history.allocate(SDFT_WINDOW_SIZE, true);
+    position = 0;
+    
+    cosTable.allocate(SDFT_WINDOW_SIZE, false);
+    sinTable.allocate(SDFT_WINDOW_SIZE, false);
+    for(int i = 0; i < SDFT_WINDOW_SIZE; i++) {
+        const double phase = MathConstants<double>::twoPi * i / SDFT_WINDOW_SIZE;
+        cosTable[i] = (float) std::cos(phase);
+        sinTable[i] = (float) std::sin(phase);
+    }
+    
+    chooseBins();
+}
+
+/*
+ Slides every tracked bin over the block and publishes the windowed magnitudes
+ The block is split where the window position wraps, which is where the bins are re-anchored
+ */
+void SlidingDFT::process(const AudioBuffer<float> &block, int numSamples) {
+    const float gain = 1.0f / jmax(1, numChannels);
+    FloatVectorOperations::copyWithMultiply(mono, block.getReadPointer(0), gain, numSamples);
+    for(int channel = 1; channel < numChannels; channel++)
+        FloatVectorOperations::addWithMultiply(mono, block.getReadPointer(channel), gain, numSamples);
+    
+    int done = 0;
+    while(done < numSamples) {
+        const int length = jmin(numSamples - done, SDFT_WINDOW_SIZE - position);
+        
+        // x[n] - x[n - N] for the segment, swapping the new samples into the history as we go
+        for(int i = 0; i < length; i++) {
+            const float sample = mono[done + i];
+            difference[i] = sample - history[position + i];
+            history[position + i] = sample;
+        }
+        
+        slide(mono + done, length);
+        
+        done += length;
+        position += length;
+        if(position == SDFT_WINDOW_SIZE)
+            reanchor();
+    }
+    
+    publish();
+}
+
+/*
+ One bin per log spaced frequency that maps to a distinct DFT bin
+ */
+int SlidingDFT::getNumBins() const {
+    return publishedBins.get();
+}
+
+/*
+ Copies the newest magnitudes, lowest frequency first, nothing is copied until the first result is published
+ */
+int SlidingDFT::readSpectrum(float *dest, int maxBins) {
+    results.fetch();
+    
+    if(! results.hasData())
+        return 0;
+    
+    const Result &result = results.getReadBuffer();
+    const int count = jlimit(0, jmin(maxBins, SDFT_NUM_BINS), result.numBins);
+    FloatVectorOperations::copy(dest, result.magnitudes, count);
+    return count;
+}
+
+/*
+ Rounds log spaced frequencies to DFT bins, dropping repeats where the lows are closer than one bin apart,
+ then collects every bin and neighbour that has to be tracked into the SIMD lanes
+ */
+void SlidingDFT::chooseBins() {
+    const double binWidth = sampleRate / SDFT_WINDOW_SIZE;
+    const double highest = jmin(SDFT_HIGHEST_FREQUENCY, 0.5 * sampleRate - binWidth);
+    const double ratio = highest / SDFT_LOWEST_FREQUENCY;
+    
+    numBins = 0;
+    numTracked = 0;
+    int lastBin = 0;
+    
+    for(int i = 0; i < SDFT_NUM_BINS; i++) {
+        const double frequency = SDFT_LOWEST_FREQUENCY * std::pow(ratio, i / (double) (SDFT_NUM_BINS - 1));
+        const int bin = jlimit(1, SDFT_WINDOW_SIZE / 2 - 2, roundToInt(frequency / binWidth));
+        
+        if(bin == lastBin)
+            continue;
+        lastBin = bin;
+        
+        // Bins are increasing, so only the last few tracked entries can already hold a neighbour
+        for(int neighbour = bin - 1; neighbour <= bin + 1; neighbour++) {
+            int index = numTracked - 1;
+            while(index >= 0 && trackedBin[index] > neighbour)
+                index--;
+            if(index < 0 || trackedBin[index] != neighbour)
+                trackedBin[index = numTracked++] = neighbour;
+            
+            if(neighbour < bin)
+                binLower[numBins] = index;
+            else if(neighbour == bin)
+                binCentre[numBins] = index;
+            else
+                binUpper[numBins] = index;
+        }
+        numBins++;
+    }
+    
+    const int width = (int) Vec::size();
+    numGroups = (numTracked + width - 1) / width;
+    
+    stepCos.allocate(numGroups);
+    stepSin.allocate(numGroups);
+    phasorRe.allocate(numGroups);
+    phasorIm.allocate(numGroups);
+    slidingRe.allocate(numGroups);
+    slidingIm.allocate(numGroups);
+    anchorRe.allocate(numGroups);
+    anchorIm.allocate(numGroups);
+    
+    for(int i = 0; i < numTracked; i++) {
+        stepCos.getRawData()[i] = cosTable[trackedBin[i]];
+        stepSin.getRawData()[i] = -sinTable[trackedBin[i]];
+    }
+    
+    reanchor();
+}
+
+/*
+ Advances every tracked bin over a segment of samples, with their differences to the samples one window back in difference[]
+ The sums are kept modulated, Y[k] = sum of x[j] e^(-2 pi i k (j mod N) / N) over the window, so sliding is just
+ adding the difference between the newest and oldest sample times a phasor and nothing feeds back on itself
+ A second sum collects only the samples since the window last wrapped, which becomes the exact DFT once it is full
+ */
+void SlidingDFT::slide(const float *samples, int numSamples) {
+    for(int group = 0; group < numGroups; group++) {
+        const Vec c = stepCos[group];
+        const Vec s = stepSin[group];
+        Vec pRe = phasorRe[group];
+        Vec pIm = phasorIm[group];
+        Vec yRe = slidingRe[group];
+        Vec yIm = slidingIm[group];
+        Vec aRe = anchorRe[group];
+        Vec aIm = anchorIm[group];
+        
+        for(int i = 0; i < numSamples; i++) {
+            const Vec d = Vec::expand(difference[i]);
+            const Vec x = Vec::expand(samples[i]);
+            yRe = yRe + d * pRe;
+            yIm = yIm + d * pIm;
+            aRe = aRe + x * pRe;
+            aIm = aIm + x * pIm;
+            
+            const Vec newRe = c * pRe - s * pIm;
+            pIm = s * pRe + c * pIm;
+            pRe = newRe;
+        }
+        
+        phasorRe[group] = pRe;
+        phasorIm[group] = pIm;
+        slidingRe[group] = yRe;
+        slidingIm[group] = yIm;
+        anchorRe[group] = aRe;
+        anchorIm[group] = aIm;
+    }
+}
+
+/*
+ Called when the window position wraps, replaces the running sums with the ones collected over the last full window
+ and resets the phasors, so rounding in the sums and the phasor rotation never builds up past one window
+ */
+void SlidingDFT::reanchor() {
+    position = 0;
+    
+    for(int group = 0; group < numGroups; group++) {
+        slidingRe[group] = anchorRe[group];
+        slidingIm[group] = anchorIm[group];
+        anchorRe[group] = Vec::expand(0.0f);
+        anchorIm[group] = Vec::expand(0.0f);
+        phasorRe[group] = Vec::expand(1.0f);
+        phasorIm[group] = Vec::expand(0.0f);
+    }
+}
+
+/*
+ Demodulates the tracked bins to the DFT of the latest window, applies the Hann window as
+ 0.5 X[k] - 0.25 (X[k - 1] + X[k + 1]) and publishes the magnitudes scaled to sinusoid amplitude
+ */
+void SlidingDFT::publish() {
+    const float *yRe = slidingRe.getRawData();
+    const float *yIm = slidingIm.getRawData();
+    float re[3 * SDFT_NUM_BINS];
+    float im[3 * SDFT_NUM_BINS];
+    
+    // X[k] = Y[k] e^(2 pi i k m / N) with m the position the next sample will be written to
+    for(int i = 0; i < numTracked; i++) {
+        const int phase = (trackedBin[i] * position) & (SDFT_WINDOW_SIZE - 1);
+        const float c = cosTable[phase];
+        const float s = sinTable[phase];
+        re[i] = yRe[i] * c - yIm[i] * s;
+        im[i] = yRe[i] * s + yIm[i] * c;
+    }
+    
+    Result &result = results.getWriteBuffer();
+    const float scale = 4.0f / SDFT_WINDOW_SIZE;
+    
+    for(int i = 0; i < numBins; i++) {
+        const float windowedRe = 0.5f * re[binCentre[i]] - 0.25f * (re[binLower[i]] + re[binUpper[i]]);
+        const float windowedIm = 0.5f * im[binCentre[i]] - 0.25f * (im[binLower[i]] + im[binUpper[i]]);
+        result.magnitudes[i] = scale * std::sqrt(windowedRe * windowedRe + windowedIm * windowedIm);
+    }
+    result.numBins = numBins;
+    results.publish();
+    publishedBins = numBins;
+}
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    SlidingDFT.h
+    Created: 19 Oct 2026 7:58:37am
+    Author:  Esteban Cambronero
+    Analysis stage that updates a set of DFT bins sample by sample for a spectrum on every block
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AnalysisStage.h"
+#include "SpectrumSource.h"
+#include "SIMDArray.h"
+#include "TripleBuffer.h"
+
+#define SDFT_WINDOW_SIZE 2048
+#define SDFT_NUM_BINS 128
+#define SDFT_LOWEST_FREQUENCY 20.0
+#define SDFT_HIGHEST_FREQUENCY 20000.0
+
+class SlidingDFT : public AnalysisStage, public SpectrumSource
+{
+public:
+    SlidingDFT();
+    void prepare(double sampleRate, int numChannels, int maxBlockSize) override;
+    void process(const AudioBuffer<float> &block, int numSamples) override;
+    int getNumBins() const override;
+    int readSpectrum(float *dest, int maxBins) override;
+private:
+    typedef dsp::SIMDRegister<float> Vec;
+    struct Result {
+        float magnitudes[SDFT_NUM_BINS];
+        int numBins;
+    };
+    void chooseBins();
+    void slide(const float *samples, int numSamples);
+    void reanchor();
+    void publish();
+    
+    double sampleRate;
+    int numChannels;
+    HeapBlock<float> mono;
+    HeapBlock<float> difference;
+    
+    // The last window of samples, indexed by position so the oldest sample is overwritten as it leaves
+    HeapBlock<float> history;
+    int position;
+    
+    // Each output bin is Hann windowed from itself and its two neighbours, so those are tracked as well
+    int numBins;
+    int numTracked;
+    int numGroups;
+    int trackedBin[3 * SDFT_NUM_BINS];
+    int binLower[SDFT_NUM_BINS];
+    int binCentre[SDFT_NUM_BINS];
+    int binUpper[SDFT_NUM_BINS];
+    HeapBlock<float> cosTable;
+    HeapBlock<float> sinTable;
+    
+    // Tracked bins run in SIMD lanes, all of them updated with every sample
+    SIMDArray<float> stepCos;
+    SIMDArray<float> stepSin;
+    SIMDArray<float> phasorRe;
+    SIMDArray<float> phasorIm;
+    SIMDArray<float> slidingRe;
+    SIMDArray<float> slidingIm;
+    SIMDArray<float> anchorRe;
+    SIMDArray<float> anchorIm;
+    
+    TripleBuffer<Result> results;
+    Atomic<int> publishedBins;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SlidingDFT)
+};
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    SpectralHistory.h
+    Created: 19 Oct 2026 5:48:02pm
+    Author:  Esteban Cambronero
+    Ring of spectrum rows stored as 8 or 16 bit quantized values
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/*
+ Each row is quantized from a float range, e.g. 0 to 1 for heights or -100 to 0 for dB, into an unsigned
+ integer type, so a 4096 bin by 10000 row history takes 41MB as uint8 or 82MB as uint16 instead of 164MB.
+ The values are in the form OpenGL reads as normalized integer attributes, so the shader does the conversion back,
+ rows are handed to the GL as they are and never converted back on the CPU.
+ */
+template <typename StorageType>
+class SpectralHistory
+{
+public:
+    SpectralHistory() : binsPerRow(0), numRows(0), newestRow(0), rangeStart(0.0f), rangeEnd(1.0f) {}
+    
+    /*
+     Reallocates the history, every row starts at the bottom of the range
+     */
+    void allocate(int bins, int rows, float start, float end) {
+        binsPerRow = bins;
+        numRows = rows;
+        newestRow = 0;
+        rangeStart = start;
+        rangeEnd = end;
+        storage.allocate((size_t) bins * (size_t) rows, true);
+        scratch.allocate((size_t) bins, true);
+    }
+    
+    /*
+     Quantizes a row of floats into the ring as the newest row, replacing the oldest
+     The scale, rounding offset and clamp run as FloatVectorOperations, which have no float to integer
+     conversion, so the narrowing is a plain truncating loop the compiler turns into vector converts and packs
+     */
+    void pushRow(const float *values) {
+        const float maxCode = (float) std::numeric_limits<StorageType>::max();
+        const float scale = maxCode / (rangeEnd - rangeStart);
+        
+        FloatVectorOperations::copyWithMultiply(scratch, values, scale, binsPerRow);
+        FloatVectorOperations::add(scratch, 0.5f - rangeStart * scale, binsPerRow);
+        FloatVectorOperations::clip(scratch, scratch, 0.5f, maxCode + 0.5f, binsPerRow);
+        
+        newestRow = (newestRow + numRows - 1) % numRows;
+        StorageType *row = storage + (size_t) newestRow * (size_t) binsPerRow;
+        const float *rounded = scratch;
+        for(int i = 0; i < binsPerRow; i++)
+            row[i] = (StorageType) (int) rounded[i];
+    }
+    
+    /*
+     Row by age, zero being the newest
+     */
+    const StorageType* getRow(int age) const noexcept {
+        return storage + (size_t) ((newestRow + age) % numRows) * (size_t) binsPerRow;
+    }
+    
+private:
+    HeapBlock<StorageType> storage;
+    HeapBlock<float> scratch;
+    int binsPerRow;
+    int numRows;
+    int newestRow;
+    float rangeStart;
+    float rangeEnd;
+    
+    JUCE_DECLARE_NON_COPYABLE(SpectralHistory)
+};
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    SpectrumBus.cpp
+    Created: 19 Oct 2026 8:24:10am
+    Author:  Esteban Cambronero
+    Process wide spectrum published once per hop for every visualizer to read in place
+  ==============================================================================
+*/
+
+#include "SpectrumBus.h"
+
+/*
+ Constructor for the bus, nothing is published until the first window of audio has been analysed
+ */
+SpectrumBus::SpectrumBus() {
+    for(int i = 0; i < SPECTRUM_BUS_NUM_SLOTS; i++) {
+        slots[i].frame.version = 0;
+        slots[i].frame.numChannels = 0;
+        slots[i].readers = 0;
+    }
+    latestSlot = -1;
+    latestVersion = 0;
+    numChannels = 0;
+    windowFill = 0;
+}
+
+/*
+ Rebuilds the analysis for the channel count, frames already published keep their own channel count
+ */
+void SpectrumBus::prepare(double, int channels, int) {
+    numChannels = jmin(channels, SPECTRUM_BUS_MAX_CHANNELS);
+    window.setSize(numChannels, SPECTRUM_BUS_WINDOW_SIZE);
+    window.clear();
+    windowFill = 0;
+    buildGraph();
+}
+
+/*
+ Collects the block into the analysis window and publishes a frame every time the window fills
+ */
+void SpectrumBus::process(const AudioBuffer<float> &block, int numSamples) {
+    int done = 0;
+    while(done < numSamples) {
+        const int length = jmin(numSamples - done, SPECTRUM_BUS_WINDOW_SIZE - windowFill);
+        
+        for(int channel = 0; channel < numChannels; channel++)
+            window.copyFrom(channel, windowFill, block, channel, done, length);
+        
+        done += length;
+        windowFill += length;
+        if(windowFill == SPECTRUM_BUS_WINDOW_SIZE) {
+            publish();
+            windowFill = 0;
+        }
+    }
+}
+
+/*
+ Version of the newest frame, 0 before anything has been published
+ Readers can compare it with the version they last drew to skip pinning a frame they have already seen
+ */
+int64 SpectrumBus::getLatestVersion() const {
+    return latestVersion.get();
+}
+
+/*
+ One branch for the mix and one for each channel, all sharing the same FFT plan
+ */
+void SpectrumBus::buildGraph() {
+    graph.clear();
+    const int input = graph.setInput(numChannels, SPECTRUM_BUS_WINDOW_SIZE);
+    
+    for(int branch = 0; branch <= numChannels; branch++) {
+        const int downmix = graph.addNode(branch == 0 ? new DownmixNode(numChannels, SPECTRUM_BUS_WINDOW_SIZE, 0, numChannels)
+                                                      : new DownmixNode(numChannels, SPECTRUM_BUS_WINDOW_SIZE, branch - 1, 1));
+        const int fft = graph.addNode(new FFTNode(SPECTRUM_BUS_ORDER, SPECTRUM_BUS_WINDOW_SIZE));
+        const int magnitude = graph.addNode(new MagnitudeNode(SPECTRUM_BUS_ORDER));
+        
+        graph.connect(input, 0, downmix, 0);
+        graph.connect(downmix, 0, fft, 0);
+        graph.connect(fft, 0, magnitude, 0);
+        graph.addOutput(magnitude, 0);
+    }
+    
+    Result result = graph.compile();
+    jassert(result.wasOk());
+    ignoreUnused(result);
+}
+
+/*
+ Analyses the window into a slot nobody is reading and makes it the newest frame
+ If every other slot is pinned the frame is dropped rather than waiting on the readers
+ */
+void SpectrumBus::publish() {
+    const int latest = latestSlot.get();
+    int slot = -1;
+    
+    for(int i = 0; i < SPECTRUM_BUS_NUM_SLOTS && slot < 0; i++)
+        if(i != latest && slots[i].readers.compareAndSetBool(-1, 0))
+            slot = i;
+    
+    if(slot < 0)
+        return;
+    
+    graph.process(window);
+    
+    Frame &frame = slots[slot].frame;
+    for(int branch = 0; branch <= numChannels; branch++)
+        FloatVectorOperations::copy(frame.magnitudes + branch * SPECTRUM_BUS_NUM_BINS, graph.getOutput(branch), SPECTRUM_BUS_NUM_BINS);
+    frame.numChannels = numChannels;
+    frame.version = latestVersion.get() + 1;
+    
+    slots[slot].readers = 0;
+    latestSlot = slot;
+    latestVersion = frame.version;
+}
+
+/*
+ Pins the newest frame, a slot being rewritten between looking it up and pinning it just means trying the newer one
+ */
+SpectrumBus::ScopedFrame::ScopedFrame(SpectrumBus &owner) : bus(owner), slot(-1), frame(nullptr) {
+    for(;;) {
+        const int latest = bus.latestSlot.get();
+        if(latest < 0)
+            return;
+        
+        Atomic<int> &readers = bus.slots[latest].readers;
+        const int count = readers.get();
+        if(count >= 0 && readers.compareAndSetBool(count + 1, count)) {
+            slot = latest;
+            frame = &bus.slots[latest].frame;
+            return;
+        }
+    }
+}
+
+/*
+ Releases the pinned frame back to the analysis
+ */
+SpectrumBus::ScopedFrame::~ScopedFrame() {
+    if(slot >= 0)
+        --bus.slots[slot].readers;
+}
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    SpectrumBus.h
+    Created: 19 Oct 2026 8:24:10am
+    Author:  Esteban Cambronero
+    Process wide spectrum published once per hop for every visualizer to read in place
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AnalysisStage.h"
+#include "AnalysisNodes.h"
+
+#define SPECTRUM_BUS_ORDER 10
+#define SPECTRUM_BUS_NUM_BINS ((1 << SPECTRUM_BUS_ORDER) / 2 + 1)
+#define SPECTRUM_BUS_WINDOW_SIZE 256
+#define SPECTRUM_BUS_MAX_CHANNELS 8
+#define SPECTRUM_BUS_NUM_SLOTS 8
+
+/*
+ Access through a SharedResourcePointer<SpectrumBus>, the owner of the analysis thread adds it as a stage
+ and every reader holds a ScopedFrame while it looks at the newest spectrum
+ */
+class SpectrumBus : public AnalysisStage
+{
+public:
+    /*
+     One published analysis, the magnitudes of the channel mix followed by those of each channel
+     */
+    struct Frame {
+        int64 version;
+        int numChannels;
+        float magnitudes[(SPECTRUM_BUS_MAX_CHANNELS + 1) * SPECTRUM_BUS_NUM_BINS];
+        
+        const float* getMix() const noexcept                { return magnitudes; }
+        const float* getChannel(int channel) const noexcept { return magnitudes + (channel + 1) * SPECTRUM_BUS_NUM_BINS; }
+    };
+    
+    /*
+     Pins the newest frame for as long as it is in scope, the analysis never writes to a pinned frame
+     */
+    class ScopedFrame
+    {
+    public:
+        ScopedFrame(SpectrumBus &bus);
+        ~ScopedFrame();
+        const Frame* get() const noexcept                   { return frame; }
+    private:
+        SpectrumBus &bus;
+        int slot;
+        const Frame *frame;
+        
+        JUCE_DECLARE_NON_COPYABLE(ScopedFrame)
+    };
+    
+    SpectrumBus();
+    void prepare(double sampleRate, int numChannels, int maxBlockSize) override;
+    void process(const AudioBuffer<float> &block, int numSamples) override;
+    int64 getLatestVersion() const;
+private:
+    // readers counts the ScopedFrames holding a slot, -1 while the analysis is writing it
+    struct Slot {
+        Frame frame;
+        Atomic<int> readers;
+    };
+    void buildGraph();
+    void publish();
+    
+    Slot slots[SPECTRUM_BUS_NUM_SLOTS];
+    Atomic<int> latestSlot;
+    Atomic<int64> latestVersion;
+    
+    int numChannels;
+    AudioBuffer<float> window;
+    int windowFill;
+    AnalysisGraph graph;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumBus)
+};
@@ -0,0 +1,29 @@
+/*
+  ==============================================================================
+
+    SpectrumSource.h
+    Created: 19 Oct 2026 1:21:37pm
+    Author:  Esteban Cambronero
+    Interface for analysis results that the meshes can draw instead of their own FFT
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+
+class SpectrumSource
+{
+public:
+    virtual ~SpectrumSource() {}
+    
+    /*
+     Number of bins in each published spectrum
+     */
+    virtual int getNumBins() const = 0;
+    
+    /*
+     Copies the most recently published spectrum into dest, lowest bin first, and returns the number of bins copied
+     Called from the render thread so implementations must not block
+     */
+    virtual int readSpectrum(float *dest, int maxBins) = 0;
+};
@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+    StereoAnalyzer.cpp
+    Created: 19 Oct 2026 5:02:17pm
+    Author:  Esteban Cambronero
+    Analysis stage for the stereo field: correlation, balance, mid/side energy per band and vectorscope points
+  ==============================================================================
+*/
+
+#include "StereoAnalyzer.h"
+
+// Crossovers between the bands, the top band is everything above the last one
+static const float bandCrossovers[STEREO_NUM_BANDS - 1] = { 100.0f, 250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f, 8000.0f };
+
+/*
+ Constructor for the stereo analyzer
+ */
+StereoAnalyzer::StereoAnalyzer() {
+    numChannels = 0;
+    numBandGroups = 0;
+    decayPerSample = 0.0f;
+    productLR = energyL = energyR = 0.0f;
+    pointPosition = numPoints = 0;
+    samplesUntilPoint = STEREO_POINT_DECIMATION;
+    correlation = 0.0f;
+    balance = 0.0f;
+}
+
+/*
+ Computes the crossover coefficients and clears the filters and integrators
+ The filters run sample by sample so nothing depends on the block size
+ */
+void StereoAnalyzer::prepare(double sampleRate, int channels, int maxBlockSize) {
+    ignoreUnused(maxBlockSize);
+    
+    const int width = (int) Vec::size();
+    
+    numChannels = channels;
+    numBandGroups = (STEREO_NUM_BANDS + width - 1) / width;
+    decayPerSample = (float) std::exp(-1.0 / (STEREO_INTEGRATION_TIME * sampleRate));
+    
+    upperCoefficients.allocate(numBandGroups);
+    lowerCoefficients.allocate(numBandGroups);
+    midUpper.allocate(numBandGroups);
+    midLower.allocate(numBandGroups);
+    sideUpper.allocate(numBandGroups);
+    sideLower.allocate(numBandGroups);
+    midBlockEnergy.allocate(numBandGroups);
+    sideBlockEnergy.allocate(numBandGroups);
+    midEnergy.allocate(numBandGroups);
+    sideEnergy.allocate(numBandGroups);
+    
+    // A coefficient of one passes the input straight through and zero holds the filter at silence,
+    // which gives the bottom band no lower edge and the top band no upper edge
+    float *upper = upperCoefficients.getRawData();
+    float *lower = lowerCoefficients.getRawData();
+    for(int band = 0; band < STEREO_NUM_BANDS; band++) {
+        upper[band] = band < STEREO_NUM_BANDS - 1 ? (float) (1.0 - std::exp(-MathConstants<double>::twoPi * bandCrossovers[band] / sampleRate)) : 1.0f;
+        lower[band] = band > 0 ? upper[band - 1] : 0.0f;
+    }
+    
+    productLR = energyL = energyR = 0.0f;
+    pointPosition = numPoints = 0;
+    samplesUntilPoint = STEREO_POINT_DECIMATION;
+}
+
+/*
+ One fused pass over the block: correlation sums, the mid/side band filters and the decimated goniometer points
+ */
+void StereoAnalyzer::process(const AudioBuffer<float> &block, int numSamples) {
+    if(numChannels == 0)
+        return;
+    
+    const float *left = block.getReadPointer(0);
+    const float *right = block.getReadPointer(numChannels > 1 ? 1 : 0);
+    
+    float blockLR = 0.0f, blockL = 0.0f, blockR = 0.0f;
+    midBlockEnergy.clear();
+    sideBlockEnergy.clear();
+    
+    for(int i = 0; i < numSamples; i++) {
+        const float l = left[i];
+        const float r = right[i];
+        const float m = 0.5f * (l + r);
+        const float s = 0.5f * (l - r);
+        
+        blockLR += l * r;
+        blockL += l * l;
+        blockR += r * r;
+        
+        const Vec mid = Vec::expand(m);
+        const Vec side = Vec::expand(s);
+        for(int group = 0; group < numBandGroups; group++) {
+            midUpper[group] += upperCoefficients[group] * (mid - midUpper[group]);
+            midLower[group] += lowerCoefficients[group] * (mid - midLower[group]);
+            sideUpper[group] += upperCoefficients[group] * (side - sideUpper[group]);
+            sideLower[group] += lowerCoefficients[group] * (side - sideLower[group]);
+            
+            const Vec midBand = midUpper[group] - midLower[group];
+            const Vec sideBand = sideUpper[group] - sideLower[group];
+            midBlockEnergy[group] += midBand * midBand;
+            sideBlockEnergy[group] += sideBand * sideBand;
+        }
+        
+        if(--samplesUntilPoint == 0) {
+            samplesUntilPoint = STEREO_POINT_DECIMATION;
+            pointX[pointPosition] = s;
+            pointY[pointPosition] = m;
+            pointPosition = (pointPosition + 1) % STEREO_MAX_POINTS;
+            numPoints = jmin(numPoints + 1, STEREO_MAX_POINTS);
+        }
+    }
+    
+    // Leaky integration per block, the block sums are weighted as if each sample had been integrated on its own
+    const float decay = std::pow(decayPerSample, (float) numSamples);
+    const float gain = 1.0f - decayPerSample;
+    productLR = productLR * decay + blockLR * gain;
+    energyL = energyL * decay + blockL * gain;
+    energyR = energyR * decay + blockR * gain;
+    
+    const Vec decayVec = Vec::expand(decay);
+    const Vec gainVec = Vec::expand(gain);
+    for(int group = 0; group < numBandGroups; group++) {
+        midEnergy[group] = midEnergy[group] * decayVec + midBlockEnergy[group] * gainVec;
+        sideEnergy[group] = sideEnergy[group] * decayVec + sideBlockEnergy[group] * gainVec;
+    }
+    
+    publish();
+}
+
+/*
+ One bin per band, showing how much of the band is side signal
+ */
+int StereoAnalyzer::getNumBins() const {
+    return STEREO_NUM_BANDS;
+}
+
+/*
+ Copies the stereo width of each band, zero for mono up to one for signal only in the side channel
+ */
+int StereoAnalyzer::readSpectrum(float *dest, int maxBins) {
+    const StereoFrame &frame = readLatest();
+    const int numBins = jmin(maxBins, STEREO_NUM_BANDS);
+    
+    for(int band = 0; band < numBins; band++) {
+        const float total = frame.midEnergy[band] + frame.sideEnergy[band];
+        dest[band] = total > 1.0e-12f ? frame.sideEnergy[band] / total : 0.0f;
+    }
+    return numBins;
+}
+
+/*
+ Returns the newest frame, only one thread may read it
+ */
+const StereoFrame& StereoAnalyzer::readLatest() {
+    results.fetch();
+    return results.getReadBuffer();
+}
+
+/*
+ Phase correlation from -1 (out of phase) through 0 (unrelated) to 1 (mono)
+ */
+float StereoAnalyzer::getCorrelation() const {
+    return correlation.get();
+}
+
+/*
+ Balance from -1 (left only) to 1 (right only)
+ */
+float StereoAnalyzer::getBalance() const {
+    return balance.get();
+}
+
+/*
+ Fills the next frame for the render side
+ */
+void StereoAnalyzer::publish() {
+    StereoFrame &frame = results.getWriteBuffer();
+    
+    const float energyProduct = std::sqrt(energyL * energyR);
+    const float energySum = energyL + energyR;
+    frame.correlation = energyProduct > 1.0e-12f ? jlimit(-1.0f, 1.0f, productLR / energyProduct) : 0.0f;
+    frame.balance = energySum > 1.0e-12f ? (energyR - energyL) / energySum : 0.0f;
+    
+    FloatVectorOperations::copy(frame.midEnergy, midEnergy.getRawData(), STEREO_NUM_BANDS);
+    FloatVectorOperations::copy(frame.sideEnergy, sideEnergy.getRawData(), STEREO_NUM_BANDS);
+    
+    const int oldest = (pointPosition - numPoints + STEREO_MAX_POINTS) % STEREO_MAX_POINTS;
+    const int firstPart = jmin(numPoints, STEREO_MAX_POINTS - oldest);
+    FloatVectorOperations::copy(frame.pointX, pointX + oldest, firstPart);
+    FloatVectorOperations::copy(frame.pointY, pointY + oldest, firstPart);
+    FloatVectorOperations::copy(frame.pointX + firstPart, pointX, numPoints - firstPart);
+    FloatVectorOperations::copy(frame.pointY + firstPart, pointY, numPoints - firstPart);
+    frame.numPoints = numPoints;
+    
+    results.publish();
+    correlation = frame.correlation;
+    balance = frame.balance;
+}
@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    StereoAnalyzer.h
+    Created: 19 Oct 2026 5:02:17pm
+    Author:  Esteban Cambronero
+    Analysis stage for the stereo field: correlation, balance, mid/side energy per band and vectorscope points
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AnalysisStage.h"
+#include "SpectrumSource.h"
+#include "SIMDArray.h"
+#include "TripleBuffer.h"
+
+#define STEREO_NUM_BANDS 8
+#define STEREO_MAX_POINTS 256
+#define STEREO_POINT_DECIMATION 4
+#define STEREO_INTEGRATION_TIME 0.3
+
+struct StereoFrame {
+    float correlation;
+    float balance;
+    float midEnergy[STEREO_NUM_BANDS];
+    float sideEnergy[STEREO_NUM_BANDS];
+    
+    // Goniometer points, oldest first, x is side and y is mid
+    float pointX[STEREO_MAX_POINTS];
+    float pointY[STEREO_MAX_POINTS];
+    int numPoints;
+};
+
+class StereoAnalyzer : public AnalysisStage, public SpectrumSource
+{
+public:
+    StereoAnalyzer();
+    void prepare(double sampleRate, int numChannels, int maxBlockSize) override;
+    void process(const AudioBuffer<float> &block, int numSamples) override;
+    int getNumBins() const override;
+    int readSpectrum(float *dest, int maxBins) override;
+    const StereoFrame& readLatest();
+    float getCorrelation() const;
+    float getBalance() const;
+private:
+    typedef dsp::SIMDRegister<float> Vec;
+    void publish();
+    
+    int numChannels;
+    int numBandGroups;
+    float decayPerSample;
+    
+    // Each band is the difference of two one-pole lowpasses, its upper and lower crossover,
+    // so every band of mid and side runs in the same SIMD lanes in one pass
+    SIMDArray<float> upperCoefficients;
+    SIMDArray<float> lowerCoefficients;
+    SIMDArray<float> midUpper;
+    SIMDArray<float> midLower;
+    SIMDArray<float> sideUpper;
+    SIMDArray<float> sideLower;
+    SIMDArray<float> midBlockEnergy;
+    SIMDArray<float> sideBlockEnergy;
+    SIMDArray<float> midEnergy;
+    SIMDArray<float> sideEnergy;
+    
+    float productLR;
+    float energyL;
+    float energyR;
+    
+    float pointX[STEREO_MAX_POINTS];
+    float pointY[STEREO_MAX_POINTS];
+    int pointPosition;
+    int numPoints;
+    int samplesUntilPoint;
+    
+    TripleBuffer<StereoFrame> results;
+    Atomic<float> correlation;
+    Atomic<float> balance;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StereoAnalyzer)
+};
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    TripleBuffer.h
+    Created: 19 Oct 2026 1:21:37pm
+    Author:  Esteban Cambronero
+    Lock free hand over of the latest result from one writer thread to one reader thread
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+
+template <typename Type>
+class TripleBuffer
+{
+public:
+    TripleBuffer() : writeIndex(0), readIndex(1), received(false) {
+        middle = 2;
+    }
+    
+    /*
+     Buffer the writer fills in before calling publish()
+     */
+    Type &getWriteBuffer() noexcept {
+        return buffers[writeIndex];
+    }
+    
+    /*
+     Swaps the filled buffer into the middle slot, marking it as new
+     */
+    void publish() noexcept {
+        writeIndex = middle.exchange(writeIndex | newDataFlag) & indexMask;
+    }
+    
+    /*
+     Picks up the newest published buffer if there is one, returns false if nothing was published since the last fetch
+     */
+    bool fetch() noexcept {
+        if((middle.get() & newDataFlag) == 0)
+            return false;
+        
+        readIndex = middle.exchange(readIndex) & indexMask;
+        received = true;
+        return true;
+    }
+    
+    /*
+     True once a fetch() has picked up a published buffer, until then the read buffer is value initialised
+     */
+    bool hasData() const noexcept {
+        return received;
+    }
+    
+    /*
+     Buffer picked up by the last fetch()
+     */
+    const Type &getReadBuffer() const noexcept {
+        return buffers[readIndex];
+    }
+    
+private:
+    enum {
+        indexMask = 3,
+        newDataFlag = 4
+    };
+    
+    Type buffers[3] {};
+    int writeIndex;
+    int readIndex;
+    bool received;
+    Atomic<int> middle;
+    
+    JUCE_DECLARE_NON_COPYABLE(TripleBuffer)
+};